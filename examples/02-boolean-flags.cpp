@@ -1,13 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optBool<"verbose">("-v", "--verbose", "Enable verbose output"),
-      optBool<"debug">("-d", "--debug", "Enable debug mode"),
-      optBool<"quiet">("-q", "--quiet", "Suppress output"));
+  auto parser = examples::booleanFlags();
 
   parser.parse(argc, argv);
 
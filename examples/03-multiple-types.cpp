@@ -1,14 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optInt<"count", int32_t>("-c", "--count", "Item count", 10),
-      optFloat<"rate", double>("-r", "--rate", "Rate multiplier", 1.5),
-      optString<"name">("-n", "--name", "User name", "guest"),
-      optInt<"size", uint64_t>("-s", "--size", "File size in bytes", 1024));
+  auto parser = examples::multipleTypes();
 
   parser.parse(argc, argv);
 
@@ -1,14 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optInt<"port">("-p", "--port", "Server port", 8080),
-      optString<"config">("-c", "--config", "Config file path"),
-      optBool<"verbose">("-v", "--verbose", "Verbose output"),
-      optHelp("-h", "--help"));
+  auto parser = examples::helpOption();
 
   parser.parse(argc, argv);
 
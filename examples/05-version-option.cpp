@@ -1,13 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optInt<"port">("-p", "--port", "Server port", 8080),
-      optVersion("MyApp v2.5.1", "-v", "--version", "Show version"),
-      optHelp("-h", "--help"));
+  auto parser = examples::versionOption();
 
   parser.parse(argc, argv);
 
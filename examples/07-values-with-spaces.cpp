@@ -1,13 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optString<"path">("-p", "--path", "File path", "/tmp/default.txt"),
-      optString<"message">("-m", "--message", "User message", "Hello World"),
-      optString<"description">("-d", "--desc", "Description text"));
+  auto parser = examples::valuesWithSpaces();
 
   parser.parse(argc, argv);
 
@@ -1,12 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
+#include "configurations.hpp"
+
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optInt<"port">("-p", "--port", "Server port", 8080),
-      optString<"host">("-h", "--host", "Server host", "localhost"));
+  auto parser = examples::errorHandling();
 
   try {
     parser.parse(argc, argv);
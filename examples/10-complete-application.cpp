@@ -1,24 +1,12 @@
 #include <etched/etched.hpp>
 #include <iostream>
 
-void showLicense() {
-  std::cout << "MIT License - Copyright (c) 2024\n";
-}
+#include "configurations.hpp"
 
 int main(int argc, const char* argv[]) {
   using namespace etched;
 
-  auto parser = ArgumentParser(
-      optString<"host">("-H", "--host", "Server hostname", "0.0.0.0"),
-      optInt<"port">("-p", "--port", "Server port", 8080),
-      optInt<"workers", uint16_t>("-w", "--workers", "Worker threads", 4),
-      optFloat<"timeout", double>("-t", "--timeout", "Request timeout (seconds)", 30.0),
-      optString<"config">("-c", "--config", "Config file path"),
-      optBool<"verbose">("-v", "--verbose", "Enable verbose logging"),
-      optBool<"debug">("-d", "--debug", "Enable debug mode"),
-      optCallback<"license">("-L", "--license", "Show license", showLicense),
-      optVersion("Server v1.0.0", "-V", "--version", "Show version"),
-      optHelp("-h", "--help"));
+  auto parser = examples::completeApplication();
 
   try {
     parser.parse(argc, argv);
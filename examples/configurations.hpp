@@ -0,0 +1,212 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <etched/etched.hpp>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+// Option sets of the example programs. The allocation test parses these
+// same configurations, so they are kept here rather than in each example.
+
+struct Point2D {
+  double x;
+  double y;
+};
+
+struct Color {
+  uint8_t r;
+  uint8_t g;
+  uint8_t b;
+};
+
+namespace etched {
+
+template <>
+inline auto fromStr<Point2D>(const char* str) -> Point2D {
+  if (!str) {
+    throw std::invalid_argument("Null pointer for Point2D");
+  }
+
+  // Tokenizer and fromView work on string_views into argv: no copies
+  Tokenizer<','> fields(str);
+  std::string_view xStr = fields.next();
+  if (fields.done()) {
+    throw std::invalid_argument("Point2D format: x,y");
+  }
+  std::string_view yStr = fields.next();
+  if (!fields.done()) {
+    throw std::invalid_argument("Point2D format: x,y");
+  }
+
+  return Point2D{fromView<double>(xStr), fromView<double>(yStr)};
+}
+
+template <>
+inline auto fromStr<Color>(const char* str) -> Color {
+  if (!str) {
+    throw std::invalid_argument("Null pointer for Color");
+  }
+
+  std::string_view input(str);
+
+  if (!input.empty() && input[0] == '#') {
+    input.remove_prefix(1);
+  }
+
+  if (input.length() != 6) {
+    throw std::invalid_argument("Color format: #RRGGBB or RRGGBB");
+  }
+
+  auto parseHex = [](std::string_view hex) -> uint8_t {
+    uint8_t channel = 0;
+    auto [ptr, ec] =
+        std::from_chars(hex.data(), hex.data() + hex.size(), channel, 16);
+    if (ec != std::errc{} || ptr != hex.data() + hex.size()) {
+      throw std::invalid_argument("Color format: #RRGGBB or RRGGBB");
+    }
+    return channel;
+  };
+
+  return Color{parseHex(input.substr(0, 2)), parseHex(input.substr(2, 2)),
+               parseHex(input.substr(4, 2))};
+}
+
+}  // namespace etched
+
+namespace examples {
+
+inline void showCredits() {
+  std::cout << "Created by: The Etched Team\n";
+  std::cout << "License: MIT\n";
+}
+
+inline void showStats() {
+  std::cout << "Statistics:\n";
+  std::cout << "  - Total users: 1337\n";
+  std::cout << "  - Uptime: 99.9%\n";
+}
+
+inline void showLicense() {
+  std::cout << "MIT License - Copyright (c) 2024\n";
+}
+
+// 01-basic-parsing
+consteval auto basicParsing() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optString<"host">("-h", "--host", "Server host", "localhost"));
+}
+
+// 02-boolean-flags
+consteval auto booleanFlags() {
+  using namespace etched;
+  return ArgumentParser(
+      optBool<"verbose">("-v", "--verbose", "Enable verbose output"),
+      optBool<"debug">("-d", "--debug", "Enable debug mode"),
+      optBool<"quiet">("-q", "--quiet", "Suppress output"));
+}
+
+// 03-multiple-types
+consteval auto multipleTypes() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"count", int32_t>("-c", "--count", "Item count", 10),
+      optFloat<"rate", double>("-r", "--rate", "Rate multiplier", 1.5),
+      optString<"name">("-n", "--name", "User name", "guest"),
+      optInt<"size", uint64_t>("-s", "--size", "File size in bytes", 1024));
+}
+
+// 04-help-option
+consteval auto helpOption() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optString<"config">("-c", "--config", "Config file path"),
+      optBool<"verbose">("-v", "--verbose", "Verbose output"),
+      optHelp("-h", "--help"));
+}
+
+// 05-version-option
+consteval auto versionOption() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optVersion("MyApp v2.5.1", "-v", "--version", "Show version"),
+      optHelp("-h", "--help"));
+}
+
+// 06-custom-callbacks
+consteval auto customCallbacks() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optCallback<"credits">("-c", "--credits", "Show credits", showCredits),
+      optCallback<"stats">("-s", "--stats", "Show statistics", showStats),
+      optHelp("-h", "--help"));
+}
+
+// 07-values-with-spaces
+consteval auto valuesWithSpaces() {
+  using namespace etched;
+  return ArgumentParser(
+      optString<"path">("-p", "--path", "File path", "/tmp/default.txt"),
+      optString<"message">("-m", "--message", "User message", "Hello World"),
+      optString<"description">("-d", "--desc", "Description text"));
+}
+
+// 08-error-handling
+consteval auto errorHandling() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optString<"host">("-h", "--host", "Server host", "localhost"));
+}
+
+// 09-integer-ranges
+consteval auto integerRanges() {
+  using namespace etched;
+  return ArgumentParser(
+      optInt<"tiny", int8_t>("-t", "--tiny", "Tiny number (-128 to 127)", 0),
+      optInt<"small", int16_t>("-s", "--small", "Small number", 0),
+      optInt<"normal", int32_t>("-n", "--normal", "Normal number", 0),
+      optInt<"big", int64_t>("-b", "--big", "Big number", 0),
+      optInt<"ubyte", uint8_t>("-u", "--ubyte", "Unsigned byte (0-255)", 0),
+      opt<Bounded<int, 1, 100>, "percent">("-p", "--percent", "Percentage",
+                                           50),
+      opt<OneOf<1, 2, 4, 8>, "workers">("-w", "--workers", "Worker count", 4),
+      optHelp("-h", "--help"));
+}
+
+// 10-complete-application
+consteval auto completeApplication() {
+  using namespace etched;
+  return ArgumentParser(
+      optString<"host">("-H", "--host", "Server hostname", "0.0.0.0"),
+      optInt<"port">("-p", "--port", "Server port", 8080),
+      optInt<"workers", uint16_t>("-w", "--workers", "Worker threads", 4),
+      optFloat<"timeout", double>("-t", "--timeout",
+                                  "Request timeout (seconds)", 30.0),
+      optString<"config">("-c", "--config", "Config file path"),
+      optBool<"verbose">("-v", "--verbose", "Enable verbose logging"),
+      optBool<"debug">("-d", "--debug", "Enable debug mode"),
+      optCallback<"license">("-L", "--license", "Show license", showLicense),
+      optVersion("Server v1.0.0", "-V", "--version", "Show version"),
+      optHelp("-h", "--help"));
+}
+
+// 11-custom-types
+consteval auto customTypes() {
+  using namespace etched;
+  return ArgumentParser(
+      opt<Point2D, "position">("-p", "--position", "Position (x,y)",
+                               Point2D{0.0, 0.0}),
+      opt<Color, "color">("-c", "--color", "Color (#RRGGBB)",
+                          Color{255, 255, 255}),
+      optBool<"verbose">("-v", "--verbose", "Verbose output"),
+      optHelp("-h", "--help"));
+}
+
+}  // namespace examples
@@ -1,13 +1,34 @@
 #pragma once
+#include <algorithm>
 #include <array>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
 #include <stdexcept>
+#include <string>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
+#include "completion.hpp"
 #include "concepts.hpp"
+#include "constraints.hpp"
+#include "errors.hpp"
+#include "files.hpp"
+#include "incremental.hpp"
+#include "lookup.hpp"
+#include "parse_state.hpp"
 #include "parsers.hpp"
 #include "sanitizers.hpp"
+#include "snapshot.hpp"
+#include "stream.hpp"
 #include "strings.hpp"
+#include "table.hpp"
+#include "trace.hpp"
 
 #ifndef ETCHED_ARGUMENT_PARSER_HPP
 #define ETCHED_ARGUMENT_PARSER_HPP
@@ -20,36 +41,660 @@ template <ParserStrategy Strategy = detail::DefaultParserStrategy,
   requires IsValidVariadicOptions<Options...>
 class ArgumentParser {
  public:
-  consteval ArgumentParser(Options... opts) : options_(initOptions(opts)...) {
+  // Instrumentation policy, set by wrapping the strategy in Traced
+  using Trace = detail::StrategyTrace<Strategy>;
+
+  consteval ArgumentParser(Options... opts)
+      : options_(initOptions(opts)...),
+        index_(detail::OptionIndex<sizeof...(Options)>::build(opts...)),
+        table_(buildTable(opts...)),
+        callbackOrder_(orderCallbacks(opts...)) {
     validateUniqueTags();
     validateUniqueFlags();
   }
 
   void parse(const int argc, const char* argv[]) {  // NOLINT
-    constexpr std::size_t argcMax = 256;
+    handleCompletion(argc, argv);
     if (argc > static_cast<int>(argcMax)) {
-      throw std::invalid_argument(
+      detail::raise<std::invalid_argument>(
           "Too many arguments: maximum " + std::to_string(argcMax) +
           " supported, got " + std::to_string(argc));
     }
     auto [cleanedArgs, cleanedArgc] =
         Sanitizer::template sanitizeArgs<argcMax>(argc, argv);
+    beginParse();
+    const auto& index = index_;
+    detail::ParseState<sizeof...(Options), Trace> state;
+    if constexpr (lazy) {
+      state.pending = pending_.data();
+    }
+    if constexpr (Trace::enabled) {
+      state.trace.sink = &trace_;
+    }
+    if constexpr (passThrough) {
+      state.passThrough = forwarded_.args.data();
+    }
+    const auto& table = table_;
+    std::apply(
+        [cleanedArgc, cleanedArgs, &index, &table,
+         &state](auto&... opts) -> auto {  // NOLINT
+          if constexpr (tableDriven) {
+            Strategy::parse(cleanedArgc, cleanedArgs, table, state, opts...);
+          } else if constexpr (requires {
+                                 Strategy::parse(cleanedArgc, cleanedArgs,
+                                                 index, state, opts...);
+                               }) {
+            Strategy::parse(cleanedArgc, cleanedArgs, index, state, opts...);
+          } else {
+            if constexpr (requires {
+                            Strategy::parse(cleanedArgc, cleanedArgs, index,
+                                            opts...);
+                          }) {
+              Strategy::parse(cleanedArgc, cleanedArgs, index, opts...);
+            } else {
+              Strategy::parse(cleanedArgc, cleanedArgs, opts...);
+            }
+            // Without a state to record into, presence means having a value
+            std::size_t idx = 0;
+            ((opts.value.has_value() ? state.seen.set(idx++) : void(++idx)),
+             ...);
+          }
+        },
+        options_);
+    seen_ = state.seen;
+    if constexpr (passThrough) {
+      forwarded_.count = state.passThroughCount;
+    }
+    checkConstraints();
+    dispatchCallbacks();
+  }
+
+  // Parses NUL-separated arguments read from fd until end of file, such as
+  // the output of find -print0, with no limit on their number. The input is
+  // read ChunkSize bytes at a time, which bounds the length of an argument.
+  // Positional arguments are not kept: they reach
+  // onBatch(std::span<const StreamArg>) in order, a batch at a time, and are
+  // valid only during the call. Values of accumulating options are applied
+  // and reported there too. Option values view the returned StreamText,
+  // which must outlive them.
+  template <std::size_t ChunkSize = 64 * 1024, typename OnBatch>
+    requires detail::IncrementalStrategy<Strategy> &&
+             (!detail::PassThroughStrategy<Strategy>) &&
+             std::invocable<OnBatch&, std::span<const StreamArg>>
+  [[nodiscard]] auto parseStream(int fd, OnBatch&& onBatch)
+      -> StreamText<sizeof...(Options)> {
+    constexpr std::size_t K = sizeof...(Options);
+    StreamText<K> text;
+    detail::StreamBatch<std::remove_reference_t<OnBatch>> batch(onBatch);
+    detail::StreamContext context{&text, &batch};
+    beginParse();
+    const detail::ValueHooks hooks = context.hooks();
+    detail::ParseState<K, Trace> state;
+    state.incremental = true;
+    state.hooks = &hooks;
+    if constexpr (lazy) {
+      state.pending = pending_.data();
+    }
+    if constexpr (Trace::enabled) {
+      state.trace.sink = &trace_;
+    }
+    const auto& index = index_;
+    bool positionalOnly = false;
+    [[maybe_unused]] std::size_t count = 0;
+    auto onToken = [&](const char* token) -> void {
+      static_cast<void>(Sanitizer::template sanitizeArgs<1>(1, &token));
+      if constexpr (Trace::enabled) {
+        state.trace.token = static_cast<std::uint16_t>(++count);
+        state.trace.comparisons = 0;
+      }
+      if (positionalOnly) {
+        batch.push(StreamArg::positional, token);
+        return;
+      }
+      const auto kind = std::apply(
+          [token, &index, &state](auto&... opts) -> auto {
+            return Strategy::parseToken(token, index, state, opts...);
+          },
+          options_);
+      if (kind == Strategy::Token::POSITIONAL) {
+        batch.push(StreamArg::positional, token);
+      } else if (kind == Strategy::Token::SEPARATOR) {
+        positionalOnly = true;
+      }
+    };
+    detail::readTokens<ChunkSize>(fd, onToken,
+                                  [&batch]() -> void { batch.flush(); });
+    if (state.awaiting != K) {
+      detail::raise<std::invalid_argument>(
+          std::string("Option requires a value: ") +
+          optionName(state.awaiting));
+    }
+    seen_ = state.seen;
+    checkConstraints();
+    dispatchCallbacks();
+    return text;
+  }
+
+  // Starts a parse that receives its tokens one at a time through push().
+  // The parser must outlive the session.
+  [[nodiscard]] auto incremental() -> IncrementalParse
+    requires detail::IncrementalStrategy<Strategy> &&
+             (!detail::PassThroughStrategy<Strategy>)
+  {
+    return IncrementalParse(parseIncrementally());
+  }
+
+  // Converts every value still pending under a lazy strategy and maps
+  // FileContents values, throwing the first error. Afterwards reads through
+  // a const parser never write to it, so it can be shared between threads.
+  auto validateAll() -> void {
+    if constexpr (lazy) {
+      [this]<std::size_t... I>(std::index_sequence<I...>) {
+        (resolve<I>(), ...);
+      }(std::make_index_sequence<sizeof...(Options)>{});
+    }
+    std::apply([](const auto&... opts) -> void { (mapContents(opts), ...); },
+               options_);
+  }
+
+  // Answers the hidden --__complete and --__completion-script arguments by
+  // writing the reply to stdout and exiting; returns for any other command
+  // line. parse() calls it too, but calling it first thing in main() skips
+  // application start-up on every <TAB>.
+  auto handleCompletion(const int argc,
+                        const char* argv[]) const -> void {  // NOLINT
+    if (auto reply = completionReply(argc, argv)) {
+      detail::writeAndExit(*reply);
+    }
+  }
+
+  // The text handleCompletion() would write, or nullopt
+  [[nodiscard]] auto completionReply(const int argc,
+                                     const char* argv[]) const  // NOLINT
+      -> std::optional<std::string> {
+    return detail::completionReply(argc, argv, index_, options_);
+  }
+
+  // Serializes every option's value and presence, and which options the
+  // last parse was given, for restore() in another process running the same
+  // binary
+  [[nodiscard]] auto snapshot() const -> std::vector<std::byte> {
+    // Pending text is converted into the copy, not into the parser
+    auto options = options_;
+    if constexpr (lazy) {
+      std::size_t idx = 0;
+      std::apply(
+          [this, &idx](auto&... opts) -> void {
+            ((pending_[idx] != nullptr
+                  ? Strategy::assignValue(opts, pending_[idx])
+                  : void(),
+              ++idx),
+             ...);
+          },
+          options);
+    }
+    detail::SnapshotWriter writer(schemaHash);
+    PresenceBits present{};
+    std::size_t idx = 0;
     std::apply(
-        [cleanedArgc, cleanedArgs](auto&... opts) -> auto {  // NOLINT
-          Strategy::parse(cleanedArgc, cleanedArgs, opts...);
+        [&present, &idx](const auto&... opts) -> void {
+          ((present[idx / 8] |= static_cast<uint8_t>(  // NOLINT
+                opts.value.has_value() << (idx % 8)),  // NOLINT
+            ++idx),
+           ...);
+        },
+        options);
+    writer.raw(present);
+    writer.raw(seen_);
+    std::apply(
+        [&writer](const auto&... opts) -> void {
+          ((opts.value ? writer.value(*opts.value) : void()), ...);
+        },
+        options);
+    return writer.take();
+  }
+
+  // Replaces all values and given<>() with those of a snapshot() blob,
+  // without parsing or converting. Restored strings view the blob, which
+  // must outlive them.
+  auto restore(std::span<const std::byte> blob) -> void {
+    detail::SnapshotReader reader(blob, schemaHash);
+    pending_ = {};
+    const auto present = reader.raw<PresenceBits>();
+    seen_ = reader.raw<detail::OptionMask<sizeof...(Options)>>();
+    std::size_t idx = 0;
+    std::apply(
+        [&reader, &present, &idx](auto&... opts) -> void {
+          ((restoreOption(reader, opts, present, idx), ++idx), ...);
         },
         options_);
+    if (!reader.done()) {
+      detail::raise<std::invalid_argument>("Trailing bytes in snapshot");
+    }
+  }
+
+  // Whether the option occurred on the command line in the last parse
+  template <detail::String Tag>
+  [[nodiscard]] auto given() const -> bool {
+    return seen_.test(findOptionIdx<Tag>());
   }
 
+  // Declaration index of the option, as reported in StreamArg::option
+  template <detail::String Tag>
+  static constexpr auto indexOf() -> std::size_t {
+    return findOptionIdx<Tag>();
+  }
+
+  // Returns a copy that checks the given constraints after every parse, e.g.
+  // .constrain(required<"input">(), exclusive<"json", "yaml">(),
+  //            dependsOn<"user", "password">())
+  // Unknown tags and contradictory constraints fail to compile.
+  consteval auto constrain(auto... constraints) const -> ArgumentParser {
+    ArgumentParser result = *this;
+    (result.addConstraint(constraints), ...);
+    result.constraints_.close();
+    result.constrained_ = !result.constraints_.empty();
+    return result;
+  }
+
+  // Under a lazy strategy the value is converted on the first access, which
+  // throws if the text is invalid
   template <detail::String Tag>
   auto getOption() -> auto& {
-    return std::get<findOptionIdx<Tag>()>(options_);
+    constexpr std::size_t idx = findOptionIdx<Tag>();
+    resolve<idx>();
+    return std::get<idx>(options_);
+  }
+
+  // Cannot convert under a lazy strategy: reading a value that is still
+  // pending is a std::logic_error, so call validateAll() or the non-const
+  // overload first
+  template <detail::String Tag>
+  [[nodiscard]] auto getOption() const -> const auto& {
+    constexpr std::size_t idx = findOptionIdx<Tag>();
+    if constexpr (lazy) {
+      if (pending_[idx] != nullptr) {
+        detail::raise<std::logic_error>(
+            std::string("Option read through a const parser before "
+                        "conversion: ") +
+            optionName(idx));
+      }
+    }
+    return std::get<idx>(options_);
   }
 
+  // Copies the options as they are: under a lazy strategy values not read
+  // yet are still unconverted, so call validateAll() first to have them all
   auto getOptions() { return options_; }
 
+  // Arguments of the last parse left for another program under a
+  // pass-through strategy, in command-line order. They point into the argv
+  // given to parse().
+  [[nodiscard]] auto passThroughArgs() const -> std::span<const char* const>
+    requires passThrough
+  {
+    return {forwarded_.args.data(), forwarded_.count};
+  }
+
+  // Fills `out` with `prefix`, the pass-through arguments and a terminating
+  // null pointer, ready for execv(). Only pointers are copied. Returns the
+  // arguments written, without the terminator.
+  auto childArgv(std::span<const char*> out,
+                 std::initializer_list<const char*> prefix = {}) const
+      -> std::span<const char*>
+    requires passThrough
+  {
+    const std::size_t count = prefix.size() + forwarded_.count;
+    if (out.size() < count + 1) {
+      detail::raise<std::out_of_range>("Buffer too small for child argv");
+    }
+    auto end = std::copy(prefix.begin(), prefix.end(), out.begin());
+    end = std::copy_n(forwarded_.args.begin(), forwarded_.count, end);
+    *end = nullptr;
+    return out.first(count);
+  }
+
+  // Instrumentation policy holding or forwarding the parse events
+  auto trace() -> Trace& { return trace_; }
+
+  [[nodiscard]] auto trace() const -> const Trace& { return trace_; }
+
  private:
+  static constexpr bool lazy = detail::LazyStrategy<Strategy>;
+  static constexpr bool passThrough = detail::PassThroughStrategy<Strategy>;
+  static constexpr bool tableDriven = detail::TableStrategy<Strategy>;
+  static constexpr std::size_t argcMax = 256;
+
+  struct NoPending {};
+
+  struct ForwardedArgs {
+    std::array<const char*, argcMax> args{};
+    std::size_t count = 0;
+  };
+
+  struct NoForwardedArgs {};
+
+  struct NoTable {};
+
   std::tuple<Options...> options_;
+  detail::OptionIndex<sizeof...(Options)> index_;
+  // Option metadata as data, kept only under a table-driven strategy
+  [[no_unique_address]] std::conditional_t<
+      tableDriven, detail::OptionTable<sizeof...(Options)>, NoTable>
+      table_{};
+  // Unconverted value text per option, kept only under a lazy strategy
+  [[no_unique_address]] std::conditional_t<
+      lazy, std::array<const char*, sizeof...(Options)>, NoPending>
+      pending_{};
+  // Pass-through arguments, kept only under a pass-through strategy
+  [[no_unique_address]] std::conditional_t<passThrough, ForwardedArgs,
+                                           NoForwardedArgs>
+      forwarded_{};
+
+  struct CallbackOrder {
+    std::array<uint8_t, sizeof...(Options)> idx{};
+    std::size_t count = 0;
+  };
+
+  // Callback options sorted by priority, ties kept in declaration order
+  CallbackOrder callbackOrder_;
+  detail::ConstraintMasks<sizeof...(Options)> constraints_{};
+  detail::OptionMask<sizeof...(Options)> seen_{};
+  bool constrained_ = false;
+  [[no_unique_address]] Trace trace_{};
+
+  // Body of incremental(): parses each token pushed, yields what it
+  // completed and, once input ends, checks the whole command line
+  auto parseIncrementally() -> detail::ParseTask {
+    constexpr std::size_t K = sizeof...(Options);
+    auto& promise = co_await detail::PromiseRequest{};
+    promise.retained.resize(K);
+    beginParse();
+    const detail::ValueHooks hooks = promise.hooks();
+    detail::ParseState<K, Trace> state;
+    state.incremental = true;
+    state.hooks = &hooks;
+    if constexpr (lazy) {
+      state.pending = pending_.data();
+    }
+    if constexpr (Trace::enabled) {
+      state.trace.sink = &trace_;
+    }
+    bool positionalOnly = false;
+    [[maybe_unused]] std::size_t count = 0;
+    while (true) {
+      const char* token = co_await detail::TokenRequest{};
+      if (token == nullptr) {
+        break;
+      }
+      static_cast<void>(Sanitizer::template sanitizeArgs<1>(1, &token));
+      if constexpr (Trace::enabled) {
+        state.trace.token = static_cast<std::uint16_t>(++count);
+        state.trace.comparisons = 0;
+      }
+      if (positionalOnly) {
+        co_yield ParseEvent{.option = ParseEvent::positional, .text = token};
+        continue;
+      }
+      promise.completed.clear();
+      const auto kind = std::apply(
+          [token, this, &state](auto&... opts) -> auto {
+            return Strategy::parseToken(token, index_, state, opts...);
+          },
+          options_);
+      promise.awaiting = state.awaiting != K
+                             ? std::optional<std::size_t>(state.awaiting)
+                             : std::nullopt;
+      for (const ParseEvent& event : promise.completed) {
+        co_yield event;
+      }
+      if (kind == Strategy::Token::POSITIONAL) {
+        co_yield ParseEvent{.option = ParseEvent::positional, .text = token};
+      } else if (kind == Strategy::Token::SEPARATOR) {
+        positionalOnly = true;
+      }
+    }
+    if (state.awaiting != K) {
+      detail::raise<std::invalid_argument>(
+          std::string("Option requires a value: ") +
+          optionName(state.awaiting));
+    }
+    seen_ = state.seen;
+    checkConstraints();
+    dispatchCallbacks();
+  }
+
+  template <detail::ConstraintKind Kind, detail::String... Tags>
+  consteval auto addConstraint(detail::Constraint<Kind, Tags...> /*unused*/)
+      -> void {
+    constexpr std::array<std::size_t, sizeof...(Tags)> idx = {
+        findOptionIdx<Tags>()...};
+    if constexpr (Kind == detail::ConstraintKind::REQUIRED) {
+      for (const std::size_t i : idx) {
+        constraints_.required.set(i);
+      }
+    } else if constexpr (Kind == detail::ConstraintKind::EXCLUSIVE) {
+      for (std::size_t n = 0; n < idx.size(); ++n) {
+        for (std::size_t m = n + 1; m < idx.size(); ++m) {
+          if (idx[n] == idx[m]) {
+            detail::raise<std::invalid_argument>(
+                "Option listed twice in an exclusive group");
+          }
+          constraints_.conflicts[idx[n]].set(idx[m]);
+          constraints_.conflicts[idx[m]].set(idx[n]);
+        }
+      }
+    } else {
+      for (std::size_t n = 1; n < idx.size(); ++n) {
+        if (idx[n] == idx[0]) {
+          detail::raise<std::invalid_argument>(
+              "Option cannot depend on itself");
+        }
+        constraints_.needs[idx[0]].set(idx[n]);
+      }
+    }
+  }
+
+  auto checkConstraints() const -> void {
+    // A terminal option such as --version answers without the others
+    if (!constrained_ || !(seen_ & terminalOptions).none()) {
+      return;
+    }
+    const auto& masks = constraints_;
+    const auto missing = seen_.missing(masks.required);
+    if (!missing.none()) {
+      detail::raise<std::invalid_argument>(
+          std::string("Missing required option: ") +
+          optionName(missing.first()));
+    }
+    for (std::size_t i = 0; i < sizeof...(Options); ++i) {
+      if (!seen_.test(i)) {
+        continue;
+      }
+      const auto conflict = seen_ & masks.conflicts[i];
+      if (!conflict.none()) {
+        detail::raise<std::invalid_argument>(
+            std::string("Options cannot be used together: ") + optionName(i) +
+            ", " + optionName(conflict.first()));
+      }
+      const auto absent = seen_.missing(masks.needs[i]);
+      if (!absent.none()) {
+        detail::raise<std::invalid_argument>(
+            std::string("Option ") + optionName(i) + " requires " +
+            optionName(absent.first()));
+      }
+    }
+  }
+
+  // Long flag if declared, else the short one
+  [[nodiscard]] auto optionName(std::size_t idx) const -> const char* {
+    const char* name = "";
+    std::size_t current = 0;
+    std::apply(
+        [idx, &current, &name](const auto&... opts) -> void {
+          static_cast<void>(((current++ == idx
+                                  ? (name = opts.longName.value_or(
+                                         opts.shortName.value_or("")),
+                                     true)
+                                  : false) ||
+                             ...));
+        },
+        options_);
+    return name;
+  }
+
+  static consteval auto terminalMask()
+      -> detail::OptionMask<sizeof...(Options)> {
+    detail::OptionMask<sizeof...(Options)> mask;
+    std::size_t idx = 0;
+    ((Options::tag == "help" || Options::tag == "version" ? mask.set(idx++)
+                                                          : void(++idx)),
+     ...);
+    return mask;
+  }
+
+  static constexpr detail::OptionMask<sizeof...(Options)> terminalOptions =
+      terminalMask();
+
+  static consteval auto buildTable(const Options&... opts) {
+    if constexpr (tableDriven) {
+      return detail::OptionTable<sizeof...(Options)>::build(opts...);
+    } else {
+      return NoTable{};
+    }
+  }
+
+  static consteval auto orderCallbacks(const Options&... opts)
+      -> CallbackOrder {
+    CallbackOrder order;
+    std::array<int, sizeof...(Options)> priorities{};
+    uint8_t current = 0;
+    auto collect = [&order, &priorities, &current](const auto& opt) -> void {
+      if constexpr (IsCallbackOption<std::remove_cvref_t<decltype(opt)>>) {
+        std::size_t pos = order.count++;
+        while (pos > 0 && priorities[pos - 1] > opt.priority) {
+          priorities[pos] = priorities[pos - 1];
+          order.idx[pos] = order.idx[pos - 1];
+          --pos;
+        }
+        priorities[pos] = opt.priority;
+        order.idx[pos] = current;
+      }
+      ++current;
+    };
+    (collect(opts), ...);
+    return order;
+  }
+
+  // Runs the callbacks of options given on the command line, after every
+  // argument has been accepted and, under a lazy strategy, converted
+  auto dispatchCallbacks() -> void {
+    if (callbackOrder_.count == 0) {
+      return;
+    }
+    bool anyTriggered = false;
+    std::apply(
+        [&anyTriggered](const auto&... opts) -> void {
+          ((anyTriggered = anyTriggered || isTriggered(opts)), ...);
+        },
+        options_);
+    if (!anyTriggered) {
+      return;
+    }
+    validateAll();
+    for (std::size_t n = 0; n < callbackOrder_.count; ++n) {
+      const std::size_t idx = callbackOrder_.idx[n];
+      std::size_t current = 0;
+      std::apply(
+          [idx, &current](auto&... opts) -> void {
+            static_cast<void>(
+                ((current++ == idx ? (runCallback(opts), true) : false) ||
+                 ...));
+          },
+          options_);
+    }
+  }
+
+  // Forgets what an earlier parse left behind, even one that failed: value
+  // text that may point into an argv gone by now, presence and callbacks
+  // still to run
+  auto beginParse() -> void {
+    if constexpr (lazy) {
+      pending_ = {};
+    }
+    seen_ = {};
+    clearTriggers();
+  }
+
+  auto clearTriggers() -> void {
+    if (callbackOrder_.count == 0) {
+      return;
+    }
+    std::apply(
+        [](auto&... opts) -> void { (clearTrigger(opts), ...); },
+        options_);
+  }
+
+  template <IsOption Opt>
+  static auto clearTrigger(Opt& opt) -> void {
+    if constexpr (IsCallbackOption<Opt>) {
+      opt.triggered = false;
+    }
+  }
+
+  template <IsOption Opt>
+  static auto isTriggered(const Opt& opt) -> bool {
+    if constexpr (IsCallbackOption<Opt>) {
+      return opt.triggered;
+    } else {
+      return false;
+    }
+  }
+
+  template <IsOption Opt>
+  static auto runCallback(Opt& opt) -> void {
+    if constexpr (IsCallbackOption<Opt>) {
+      if (opt.triggered) {
+        opt.triggered = false;
+        opt.triggerCallback();
+      }
+    }
+  }
+
+  template <std::size_t I>
+  auto resolve() -> void {
+    if constexpr (lazy) {
+      if (pending_[I] != nullptr) {
+        Strategy::assignValue(std::get<I>(options_), pending_[I]);
+        pending_[I] = nullptr;
+      }
+    }
+  }
+
+  // FileContents map their file on first access through mutable members
+  template <IsOption Opt>
+  static auto mapContents(const Opt& opt) -> void {
+    if constexpr (std::is_same_v<typename Opt::ValueType, FileContents>) {
+      if (opt.value) {
+        static_cast<void>(opt.value->view());
+      }
+    }
+  }
+
+  static constexpr uint64_t schemaHash = detail::schemaHash<Options...>();
+
+  using PresenceBits = std::array<uint8_t, (sizeof...(Options) + 7) / 8>;
+
+  template <IsOption Opt>
+  static auto restoreOption(detail::SnapshotReader& reader, Opt& opt,
+                            const PresenceBits& present, std::size_t idx)
+      -> void {
+    if (((present[idx / 8] >> (idx % 8)) & 1U) != 0) {  // NOLINT
+      opt.value = reader.value<typename Opt::ValueType>();
+    } else {
+      opt.value = std::nullopt;
+    }
+  }
 
   template <IsOption Opt>
   static consteval auto initOptions(Opt opt) -> Opt {
@@ -67,7 +712,7 @@ class ArgumentParser {
         using Opt1 = std::tuple_element_t<I, std::tuple<Options...>>;
         using Opt2 = std::tuple_element_t<J, std::tuple<Options...>>;
         if constexpr (Opt1::tag == Opt2::tag) {
-          throw std::invalid_argument("Duplicate option tag detected");
+          detail::raise<std::invalid_argument>("Duplicate option tag detected");
         }
         validateUniqueTags<I, J + 1>();
       } else {
@@ -85,12 +730,14 @@ class ArgumentParser {
         const auto& opt2 = std::get<J>(options_);
         if (opt1.shortName && opt2.shortName) {
           if (detail::equals(opt1.shortName.value(), opt2.shortName.value())) {
-            throw std::invalid_argument("Duplicate short flag detected");
+            detail::raise<std::invalid_argument>(
+                "Duplicate short flag detected");
           }
         }
         if (opt1.longName && opt2.longName) {
           if (detail::equals(opt1.longName.value(), opt2.longName.value())) {
-            throw std::invalid_argument("Duplicate long flag detected");
+            detail::raise<std::invalid_argument>(
+                "Duplicate long flag detected");
           }
         }
         validateUniqueFlags<I, J + 1>();
@@ -115,6 +762,17 @@ class ArgumentParser {
   }
 };
 
+// Builds a parser with explicit strategies, e.g.
+// makeParser<detail::LazyParserStrategy>(opts...), since class template
+// argument deduction cannot take them alongside deduced options
+template <ParserStrategy Strategy,
+          SanitizerStrategy Sanitizer = detail::BasicSanitizer,
+          IsOption... Options>
+  requires IsValidVariadicOptions<Options...>
+consteval auto makeParser(Options... opts) {
+  return ArgumentParser<Strategy, Sanitizer, Options...>(opts...);
+}
+
 }  // namespace etched
 
 #endif  // ETCHED_ARGUMENT_PARSER_HPP
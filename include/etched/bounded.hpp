@@ -0,0 +1,204 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "converters.hpp"
+#include "errors.hpp"
+#include "strings.hpp"
+
+#ifndef ETCHED_BOUNDED_HPP
+#define ETCHED_BOUNDED_HPP
+
+namespace etched {
+
+namespace detail {
+
+template <typename T>
+concept BoundableValue =
+    (Integer<T> && !std::same_as<T, bool>) || std::is_floating_point_v<T>;
+
+// Widens character-sized integers so they print as numbers
+template <typename T>
+constexpr auto printable(T value) {
+  if constexpr (Integer<T>) {
+    return +value;
+  } else {
+    return value;
+  }
+}
+
+}  // namespace detail
+
+// Numeric value restricted to [Min, Max]. Integers are range-checked while
+// their digits are parsed.
+template <typename T, T Min, T Max>
+  requires detail::BoundableValue<T> && (Min <= Max)
+class Bounded {
+ public:
+  using UnderlyingType = T;
+  static constexpr T min = Min;
+  static constexpr T max = Max;
+
+  constexpr Bounded(T value) : value_(value) {  // NOLINT
+    if (value < Min || value > Max) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+  }
+
+  constexpr operator T() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> T { return value_; }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "[" << detail::printable(Min) << ".." << detail::printable(Max)
+       << "]";
+  }
+
+ private:
+  T value_;
+};
+
+// Integer restricted to a fixed set, e.g. OneOf<1, 2, 4, 8>
+template <auto First, auto... Rest>
+  requires detail::BoundableValue<decltype(First)> &&
+           detail::Integer<decltype(First)> &&
+           (std::same_as<decltype(First), decltype(Rest)> && ...)
+class OneOf {
+ public:
+  using UnderlyingType = decltype(First);
+
+  constexpr OneOf(UnderlyingType value) : value_(value) {  // NOLINT
+    if (!contains(value)) {
+      detail::raise<std::out_of_range>("Value not in allowed set");
+    }
+  }
+
+  constexpr operator UnderlyingType() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> UnderlyingType { return value_; }
+
+  // Range spanned by the set, checked during digit accumulation
+  static constexpr auto lowest() -> UnderlyingType {
+    return std::min({First, Rest...});
+  }
+
+  static constexpr auto highest() -> UnderlyingType {
+    return std::max({First, Rest...});
+  }
+
+  static constexpr auto contains(UnderlyingType value) -> bool {
+    return value == First || ((value == Rest) || ...);
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "{" << detail::printable(First);
+    ((os << "|" << detail::printable(Rest)), ...);
+    os << "}";
+  }
+
+ private:
+  UnderlyingType value_;
+};
+
+// String restricted to a fixed set, e.g. OneOfStr<"fast", "safe">. The value
+// views the matched entry of the set, not the argument it was parsed from.
+template <detail::String First, detail::String... Rest>
+class OneOfStr {
+ public:
+  using UnderlyingType = std::string_view;
+  static constexpr std::array<std::string_view, sizeof...(Rest) + 1> names = {
+      First.view(), Rest.view()...};
+
+  constexpr OneOfStr(std::string_view value) : value_(find(value)) {  // NOLINT
+    if (value_.data() == nullptr) {
+      detail::raise<std::out_of_range>("Value not in allowed set");
+    }
+  }
+
+  constexpr operator std::string_view() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> std::string_view {
+    return value_;
+  }
+
+  static constexpr auto contains(std::string_view value) -> bool {
+    return find(value).data() != nullptr;
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "{" << First.view();
+    ((os << "|" << Rest.view()), ...);
+    os << "}";
+  }
+
+ private:
+  std::string_view value_;
+
+  static constexpr auto find(std::string_view value) -> std::string_view {
+    std::string_view match{};
+    static_cast<void>(
+        (value == First.view() && (match = First.view(), true)) ||
+        ((value == Rest.view() && (match = Rest.view(), true)) || ...));
+    return match;
+  }
+};
+
+namespace detail {
+
+template <typename T>
+struct IsBoundedType : std::false_type {};
+
+template <typename T, T Min, T Max>
+struct IsBoundedType<Bounded<T, Min, Max>> : std::true_type {};
+
+template <typename T>
+struct IsOneOfType : std::false_type {};
+
+template <auto First, auto... Rest>
+struct IsOneOfType<OneOf<First, Rest...>> : std::true_type {};
+
+template <String First, String... Rest>
+struct IsOneOfType<OneOfStr<First, Rest...>> : std::true_type {};
+
+template <typename T>
+concept BoundedValue = IsBoundedType<T>::value;
+
+template <typename T>
+concept OneOfValue = IsOneOfType<T>::value;
+
+}  // namespace detail
+
+template <detail::BoundedValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  using U = typename T::UnderlyingType;
+  if constexpr (detail::Integer<U>) {
+    return T(detail::parseInteger<U>(str, T::min, T::max));
+  } else {
+    return T(fromStr<U>(str));
+  }
+}
+
+template <detail::OneOfValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  using U = typename T::UnderlyingType;
+  if constexpr (std::same_as<U, std::string_view>) {
+    return T(std::string_view(str));
+  } else {
+    return T(detail::parseInteger<U>(str, T::lowest(), T::highest()));
+  }
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_BOUNDED_HPP
@@ -0,0 +1,281 @@
+#pragma once
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#include "concepts.hpp"
+#include "errors.hpp"
+#include "lookup.hpp"
+
+#ifndef ETCHED_COMPLETION_HPP
+#define ETCHED_COMPLETION_HPP
+
+namespace etched {
+
+enum class Shell : std::uint8_t { BASH, ZSH };
+
+inline auto completionScript(Shell shell, std::string_view program)
+    -> std::string;
+
+namespace detail {
+
+// Hidden arguments answered before normal parsing:
+//   prog --__complete <cword> <words...>   candidates for words[cword]
+//   prog --__completion-script <bash|zsh>  glue script for the shell
+constexpr std::string_view completeFlag = "--__complete";
+constexpr std::string_view completionScriptFlag = "--__completion-script";
+
+// Value types whose accepted values are a fixed list of names
+template <typename T>
+concept HasValueNames = requires {
+  { T::names.size() } -> std::convertible_to<std::size_t>;
+  { T::names[0] } -> std::convertible_to<std::string_view>;
+};
+
+// Appends "candidate\tdescription\n"
+inline auto addCandidate(std::string& out, std::string_view prefix,
+                         std::string_view name, const char* description)
+    -> void {
+  out.append(prefix);
+  out.append(name);
+  if (description != nullptr) {
+    out.push_back('\t');
+    out.append(description);
+  }
+  out.push_back('\n');
+}
+
+// Candidates for `current` given the word before it, one per line
+template <std::size_t K, IsOption... Options>
+auto completionCandidates(const OptionIndex<K>& index,
+                          std::string_view previous, std::string_view current,
+                          const std::tuple<Options...>& options)
+    -> std::string {
+  std::string out;
+  // Value of the previous option, or of --name=value in the current word
+  std::size_t valueOf = OptionIndex<K>::npos;
+  std::string_view valuePrefix;
+  const std::size_t eq = current.find('=');
+  if (current.starts_with("--") && eq != std::string_view::npos) {
+    valueOf = index.findLong(current.substr(2, eq - 2));
+    valuePrefix = current.substr(0, eq + 1);
+    current.remove_prefix(eq + 1);
+  } else if (previous.starts_with("--")) {
+    valueOf = index.findLong(previous.substr(2));
+  } else if (previous.size() == 2 && previous[0] == '-') {
+    valueOf = index.findShort(previous[1]);
+  }
+  if (valueOf != OptionIndex<K>::npos) {
+    std::size_t currentIdx = 0;
+    bool takesValue = false;
+    std::apply(
+        [&](const auto&... opts) -> void {
+          auto values = [&](const auto& opt) -> void {
+            using Opt = std::remove_cvref_t<decltype(opt)>;
+            using ValueType = typename Opt::ValueType;
+            if (currentIdx++ != valueOf) {
+              return;
+            }
+            takesValue = !std::is_same_v<ValueType, bool> &&
+                         !CountingValue<ValueType>;
+            if constexpr (HasValueNames<ValueType>) {
+              for (const std::string_view name : ValueType::names) {
+                if (name.starts_with(current)) {
+                  addCandidate(out, valuePrefix, name, nullptr);
+                }
+              }
+            }
+          };
+          (values(opts), ...);
+        },
+        options);
+    if (takesValue) {
+      return out;
+    }
+  }
+  if (!current.empty() && current[0] != '-') {
+    return out;
+  }
+  std::array<const char*, K> descriptions{};
+  std::array<const char*, K> shortNames{};
+  std::size_t idx = 0;
+  std::apply(
+      [&](const auto&... opts) -> void {
+        ((descriptions[idx] = opts.description.value_or(nullptr),
+          shortNames[idx] = opts.shortName.value_or(nullptr), ++idx),
+         ...);
+      },
+      options);
+  const std::string_view prefix =
+      current.starts_with("--") ? current.substr(2) : std::string_view{};
+  const auto [first, last] = index.findPrefix(prefix);
+  for (std::size_t n = first; n < last; ++n) {
+    const std::size_t opt = index.longOrder[n];
+    addCandidate(out, "--", index.longNames[opt], descriptions[opt]);
+  }
+  if (current.size() <= 1) {
+    for (std::size_t opt = 0; opt < K; ++opt) {
+      const char* name = shortNames[opt];
+      if (name != nullptr && name[0] == '-' && name[1] != '-' &&
+          name[1] != '\0') {
+        addCandidate(out, "", name, descriptions[opt]);
+      }
+    }
+  }
+  return out;
+}
+
+// Reply to a hidden completion request in argv, or nullopt when argv is an
+// ordinary command line. Words split by bash at '=' ("--opt" "=" "val") are
+// treated like "--opt val".
+template <std::size_t K, IsOption... Options>
+auto completionReply(int argc, const char* argv[],  // NOLINT
+                     const OptionIndex<K>& index,
+                     const std::tuple<Options...>& options)
+    -> std::optional<std::string> {
+  if (argc < 2 || argv[1] == nullptr) {
+    return std::nullopt;
+  }
+  const std::string_view mode = argv[1];
+  if (mode == completionScriptFlag) {
+    if (argc != 3 || argv[2] == nullptr) {
+      detail::raise<std::invalid_argument>(
+          "Expected a shell name: bash or zsh");
+    }
+    const std::string_view shell = argv[2];
+    if (shell != "bash" && shell != "zsh") {
+      detail::raise<std::invalid_argument>(
+          "Unsupported shell: " + std::string(shell));
+    }
+    return completionScript(shell == "bash" ? Shell::BASH : Shell::ZSH,
+                            argv[0] != nullptr ? argv[0] : "");
+  }
+  if (mode != completeFlag) {
+    return std::nullopt;
+  }
+  if (argc < 3 || argv[2] == nullptr) {
+    detail::raise<std::invalid_argument>(
+        "Expected the index of the word to complete");
+  }
+  const std::string_view cwordText = argv[2];
+  std::size_t cword = 0;
+  const auto [ptr, ec] = std::from_chars(
+      cwordText.data(), cwordText.data() + cwordText.size(), cword);
+  if (ec != std::errc{} || ptr != cwordText.data() + cwordText.size()) {
+    detail::raise<std::invalid_argument>(
+        "Invalid word index: " + std::string(cwordText));
+  }
+  const std::span<const char*> words(argv + 3,
+                                     static_cast<std::size_t>(argc - 3));
+  const auto word = [&words](std::size_t n) -> std::string_view {
+    return n < words.size() && words[n] != nullptr ? words[n] : "";
+  };
+  std::string_view current = word(cword);
+  std::string_view previous = cword > 0 ? word(cword - 1) : "";
+  if (current == "=") {
+    current = "";
+  } else if (previous == "=" && cword > 1) {
+    previous = word(cword - 2);
+  }
+  return completionCandidates(index, previous, current, options);
+}
+
+// Writes `text` to stdout in one call and exits
+[[noreturn]] inline auto writeAndExit(const std::string& text) -> void {
+#if __has_include(<unistd.h>)
+  std::size_t written = 0;
+  while (written < text.size()) {
+    const auto n = ::write(STDOUT_FILENO, text.data() + written,
+                           text.size() - written);
+    if (n <= 0) {
+      break;
+    }
+    written += static_cast<std::size_t>(n);
+  }
+  std::_Exit(0);
+#else
+  std::fwrite(text.data(), 1, text.size(), stdout);
+  std::fflush(stdout);
+  std::exit(0);
+#endif
+}
+
+// Shell identifier derived from the program name
+inline auto completionFunctionName(std::string_view program) -> std::string {
+  const std::size_t slash = program.rfind('/');
+  if (slash != std::string_view::npos) {
+    program.remove_prefix(slash + 1);
+  }
+  std::string name = "_etched_";
+  for (const char c : program) {
+    const bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                      (c >= '0' && c <= '9') || c == '_';
+    name.push_back(word ? c : '_');
+  }
+  return name;
+}
+
+}  // namespace detail
+
+// Completion glue for `program`, which answers through --__complete. Load it
+// with e.g. source <(prog --__completion-script bash).
+inline auto completionScript(Shell shell, std::string_view program)
+    -> std::string {
+  const std::size_t slash = program.rfind('/');
+  const std::string command(
+      slash == std::string_view::npos ? program : program.substr(slash + 1));
+  const std::string function = detail::completionFunctionName(program);
+  std::string script;
+  if (shell == Shell::BASH) {
+    script += function + "() {\n";
+    script += "  local IFS=$'\\n' line\n";
+    script += "  COMPREPLY=()\n";
+    script +=
+        "  for line in $(\"${COMP_WORDS[0]}\" --__complete \"$COMP_CWORD\" "
+        "\"${COMP_WORDS[@]}\" 2>/dev/null); do\n";
+    script += "    COMPREPLY+=(\"${line%%$'\\t'*}\")\n";
+    script += "  done\n";
+    script += "}\n";
+    script += "complete -o default -F " + function + " " + command +
+              "\n";
+  } else {
+    script += "#compdef " + command + "\n";
+    script += function + "() {\n";
+    script += "  local -a candidates\n";
+    script += "  local line\n";
+    script +=
+        "  for line in \"${(@f)$(\"${words[1]}\" --__complete "
+        "$((CURRENT - 1)) \"${words[@]}\" 2>/dev/null)}\"; do\n";
+    script += "    [[ -z $line ]] && continue\n";
+    script += "    if [[ $line == *$'\\t'* ]]; then\n";
+    script +=
+        "      candidates+=(\"${${line%%$'\\t'*}//:/\\\\:}:${line#*$'\\t'}\")\n";
+    script += "    else\n";
+    script += "      candidates+=(\"${line//:/\\\\:}\")\n";
+    script += "    fi\n";
+    script += "  done\n";
+    script += "  _describe 'option' candidates || _files\n";
+    script += "}\n";
+    script += "compdef " + function + " " + command + "\n";
+  }
+  return script;
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_COMPLETION_HPP
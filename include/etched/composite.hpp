@@ -0,0 +1,240 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "bounded.hpp"
+#include "converters.hpp"
+#include "enums.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_COMPOSITE_HPP
+#define ETCHED_COMPOSITE_HPP
+
+namespace etched {
+
+// Splits a string_view at a compile-time delimiter without allocating. An
+// input with k delimiters yields k + 1 fields, empty fields included.
+template <char Delim>
+class Tokenizer {
+ public:
+  struct Sentinel {};
+
+  class Iterator {
+   public:
+    constexpr Iterator(Tokenizer* tokenizer, std::string_view field)
+        : tokenizer_(tokenizer), field_(field) {}
+
+    constexpr auto operator*() const -> std::string_view { return field_; }
+
+    constexpr auto operator++() -> Iterator& {
+      if (tokenizer_->done()) {
+        tokenizer_ = nullptr;
+      } else {
+        field_ = tokenizer_->next();
+      }
+      return *this;
+    }
+
+    constexpr auto operator==(Sentinel /*unused*/) const -> bool {
+      return tokenizer_ == nullptr;
+    }
+
+   private:
+    Tokenizer* tokenizer_;
+    std::string_view field_;
+  };
+
+  constexpr explicit Tokenizer(std::string_view input) : rest_(input) {}
+
+  [[nodiscard]] constexpr auto done() const -> bool { return done_; }
+
+  // Returns the next field; must not be called once done() is true
+  constexpr auto next() -> std::string_view {
+    const std::size_t pos = rest_.find(Delim);
+    if (pos == std::string_view::npos) {
+      done_ = true;
+      return std::exchange(rest_, std::string_view{});
+    }
+    const std::string_view field = rest_.substr(0, pos);
+    rest_.remove_prefix(pos + 1);
+    return field;
+  }
+
+  constexpr auto begin() -> Iterator { return Iterator(this, next()); }
+
+  constexpr auto end() const -> Sentinel { return {}; }
+
+ private:
+  std::string_view rest_;
+  bool done_ = false;
+};
+
+// Composite value split at a delimiter other than ',', e.g.
+// Delimited<std::array<int, 2>, 'x'> for "1920x1080"
+template <typename T, char Delim>
+class Delimited {
+ public:
+  using UnderlyingType = T;
+  static constexpr char delimiter = Delim;
+
+  constexpr Delimited(T value) : value_(std::move(value)) {}  // NOLINT
+
+  constexpr operator const T&() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> const T& { return value_; }
+
+ private:
+  T value_;
+};
+
+namespace detail {
+
+template <typename T>
+struct CompositeTraits : std::false_type {};
+
+template <typename... Ts>
+struct CompositeTraits<std::tuple<Ts...>> : std::true_type {
+  static constexpr char delimiter = ',';
+};
+
+template <typename A, typename B>
+struct CompositeTraits<std::pair<A, B>> : std::true_type {
+  static constexpr char delimiter = ',';
+};
+
+template <typename T, std::size_t N>
+struct CompositeTraits<std::array<T, N>> : std::true_type {
+  static constexpr char delimiter = ',';
+};
+
+template <typename T, char Delim>
+struct CompositeTraits<Delimited<T, Delim>> : std::true_type {
+  static constexpr char delimiter = Delim;
+};
+
+template <typename T>
+struct IsDelimited : std::false_type {};
+
+template <typename T, char Delim>
+struct IsDelimited<Delimited<T, Delim>> : std::true_type {};
+
+template <typename T>
+concept CompositeValue = CompositeTraits<T>::value;
+
+// Longest value handed to a user fromStr<T> through the stack buffer
+constexpr std::size_t fallbackBufferSize = 256;
+
+}  // namespace detail
+
+template <typename T>
+auto fromView(std::string_view str) -> T;
+
+namespace detail {
+
+// Splits `str` into exactly N fields
+template <char Delim, std::size_t N>
+constexpr auto splitExact(std::string_view str)
+    -> std::array<std::string_view, N> {
+  std::array<std::string_view, N> fields{};
+  Tokenizer<Delim> tokenizer(str);
+  for (auto& field : fields) {
+    if (tokenizer.done()) {
+      detail::raise<std::invalid_argument>("Too few fields in composite value");
+    }
+    field = tokenizer.next();
+  }
+  if (!tokenizer.done()) {
+    detail::raise<std::invalid_argument>("Too many fields in composite value");
+  }
+  return fields;
+}
+
+template <typename T, char Delim>
+auto fromViewComposite(std::string_view str) -> T {
+  if constexpr (IsDelimited<T>::value) {
+    using U = typename T::UnderlyingType;
+    return T(fromViewComposite<U, T::delimiter>(str));
+  } else {
+    constexpr std::size_t count = std::tuple_size_v<T>;
+    const auto fields = splitExact<Delim, count>(str);
+    return [&fields]<std::size_t... I>(std::index_sequence<I...>) -> T {
+      return T{fromView<std::tuple_element_t<I, T>>(fields[I])...};
+    }(std::make_index_sequence<count>{});
+  }
+}
+
+}  // namespace detail
+
+// Converts a value that is not NUL-terminated, such as a field produced by
+// Tokenizer. Built-in types convert in place; other types are copied into a
+// stack buffer and handed to their fromStr<T> specialization.
+template <typename T>
+auto fromView(std::string_view str) -> T {
+  static_assert(!std::is_same_v<T, const char*>,
+                "Use std::string_view for string fields");
+  if constexpr (std::is_same_v<T, std::string_view>) {
+    return str;
+  } else if constexpr (std::is_same_v<T, bool>) {
+    return detail::parseInteger<uint8_t>(str, 0, 1) != 0;
+  } else if constexpr (std::is_same_v<T, char>) {
+    if (str.size() != 1) {
+      detail::raise<std::invalid_argument>("Invalid char value");
+    }
+    return str[0];
+  } else if constexpr (detail::Integer<T>) {
+    return detail::parseInteger<T>(str, std::numeric_limits<T>::min(),
+                                   std::numeric_limits<T>::max());
+  } else if constexpr (std::is_floating_point_v<T>) {
+    return detail::fromViewFloat<T>(str);
+  } else if constexpr (detail::BoundedValue<T>) {
+    using U = typename T::UnderlyingType;
+    if constexpr (detail::Integer<U>) {
+      return T(detail::parseInteger<U>(str, T::min, T::max));
+    } else {
+      return T(detail::fromViewFloat<U>(str));
+    }
+  } else if constexpr (detail::OneOfValue<T>) {
+    using U = typename T::UnderlyingType;
+    if constexpr (std::is_same_v<U, std::string_view>) {
+      return T(str);
+    } else {
+      return T(detail::parseInteger<U>(str, T::lowest(), T::highest()));
+    }
+  } else if constexpr (detail::EnumValueType<T>) {
+    return T::fromName(str);
+  } else if constexpr (detail::CompositeValue<T>) {
+    return detail::fromViewComposite<T, detail::CompositeTraits<T>::delimiter>(
+        str);
+  } else {
+    std::array<char, detail::fallbackBufferSize> buffer;  // NOLINT
+    if (str.size() >= buffer.size()) {
+      detail::raise<std::invalid_argument>("Value too long");
+    }
+    std::copy(str.begin(), str.end(), buffer.begin());
+    buffer[str.size()] = '\0';
+    return fromStr<T>(buffer.data());
+  }
+}
+
+// Tuples, pairs and arrays, comma-separated unless wrapped in Delimited
+template <detail::CompositeValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  return fromView<T>(str);
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_COMPOSITE_HPP
@@ -2,6 +2,7 @@
 #include <array>
 #include <concepts>
 #include <cstdint>
+#include <iosfwd>
 #include <optional>
 #ifndef ETCHED_CONCEPTS_HPP
 #define ETCHED_CONCEPTS_HPP
@@ -19,6 +20,24 @@ concept HasFromStr = requires {
   { fromStr<T>("") } -> std::same_as<T>;
 };
 
+// Value types that describe their accepted values in the help text
+template <typename T>
+concept HasValueHint = requires(std::ostream& os) { T::printValueHint(os); };
+
+// Value types whose repeated occurrences build on the current value instead
+// of replacing it
+template <typename T>
+concept AccumulatingValue =
+    requires(std::optional<T>& current, const char* str) {
+      T::accumulate(current, str);
+    };
+
+// Flag-like value types updated on each occurrence without taking a value
+template <typename T>
+concept CountingValue = requires(std::optional<T>& current) {
+  T::increment(current);
+};
+
 }  // namespace detail
 
 template <typename T>
@@ -35,7 +54,11 @@ template <typename T>
 concept ISCallback = std::is_invocable_r_v<void, T>;
 
 template <typename T>
-concept IsCallbackOption = IsOption<T> && ISCallback<typename T::CallbackT>;
+concept IsCallbackOption = IsOption<T> && requires(T t) {
+  typename T::CallbackT;
+  { t.triggered } -> std::same_as<bool&>;
+  t.triggerCallback();
+};
 
 template <typename T>
 concept SanitizerStrategy = requires {
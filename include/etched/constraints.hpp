@@ -0,0 +1,116 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "errors.hpp"
+#include "parse_state.hpp"
+#include "strings.hpp"
+
+#ifndef ETCHED_CONSTRAINTS_HPP
+#define ETCHED_CONSTRAINTS_HPP
+
+namespace etched {
+
+namespace detail {
+
+enum class ConstraintKind : std::uint8_t { REQUIRED, EXCLUSIVE, DEPENDS };
+
+template <ConstraintKind Kind, String... Tags>
+struct Constraint {
+  static constexpr ConstraintKind kind = Kind;
+};
+
+// Constraints resolved to masks: the options that must occur, and per option
+// those it needs and those it excludes. Checking a parse costs a few word
+// operations per option given.
+template <std::size_t K>
+struct ConstraintMasks {
+  OptionMask<K> required;
+  std::array<OptionMask<K>, K> needs{};
+  std::array<OptionMask<K>, K> conflicts{};
+
+  [[nodiscard]] constexpr auto empty() const -> bool {
+    if (!required.none()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < K; ++i) {
+      if (!needs[i].none() || !conflicts[i].none()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Extends needs to everything reachable through dependencies and rejects
+  // options that could never be given
+  constexpr auto close() -> void {
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (std::size_t i = 0; i < K; ++i) {
+        OptionMask<K> reach = needs[i];
+        for (std::size_t j = 0; j < K; ++j) {
+          if (needs[i].test(j)) {
+            reach |= needs[j];
+          }
+        }
+        if (!(reach == needs[i])) {
+          needs[i] = reach;
+          changed = true;
+        }
+      }
+    }
+    for (std::size_t i = 0; i < K; ++i) {
+      OptionMask<K> implied = needs[i];
+      implied.set(i);
+      for (std::size_t j = 0; j < K; ++j) {
+        if (implied.test(j) && !(conflicts[j] & implied).none()) {
+          detail::raise<std::invalid_argument>(
+              "Contradictory constraints: an option requires an option it "
+              "excludes");
+        }
+      }
+    }
+    OptionMask<K> implied = required;
+    for (std::size_t i = 0; i < K; ++i) {
+      if (required.test(i)) {
+        implied |= needs[i];
+      }
+    }
+    for (std::size_t i = 0; i < K; ++i) {
+      if (implied.test(i) && !(conflicts[i] & implied).none()) {
+        detail::raise<std::invalid_argument>(
+            "Contradictory constraints: required options exclude each other");
+      }
+    }
+  }
+};
+
+}  // namespace detail
+
+// Options that must occur on the command line
+template <detail::String... Tags>
+  requires(sizeof...(Tags) > 0)
+consteval auto required() {
+  return detail::Constraint<detail::ConstraintKind::REQUIRED, Tags...>{};
+}
+
+// Options of which at most one may occur
+template <detail::String... Tags>
+  requires(sizeof...(Tags) > 1)
+consteval auto exclusive() {
+  return detail::Constraint<detail::ConstraintKind::EXCLUSIVE, Tags...>{};
+}
+
+// If the first option occurs, all of the others must occur too
+template <detail::String Tag, detail::String... Needed>
+  requires(sizeof...(Needed) > 0)
+consteval auto dependsOn() {
+  return detail::Constraint<detail::ConstraintKind::DEPENDS, Tag, Needed...>{};
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_CONSTRAINTS_HPP
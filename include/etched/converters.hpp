@@ -1,10 +1,14 @@
 #pragma once
+#include <charconv>
 #include <concepts>
+#include <cstddef>
 #include <cstdint>
-#include <cstdlib>
 #include <limits>
 #include <stdexcept>
 #include <string_view>
+#include <system_error>
+
+#include "errors.hpp"
 
 #ifndef ETCHED_CONVERTERS_HPP
 #define ETCHED_CONVERTERS_HPP
@@ -26,25 +30,73 @@ concept UnsignedInteger = std::is_integral_v<T> && std::is_unsigned_v<T>;
 template <typename T>
 concept Integer = SignedInteger<T> || UnsignedInteger<T>;
 
-template <SignedInteger T>
-constexpr auto fromStrSigInt(const char* str) -> T {
-  int64_t val = std::stoll(str);
-  T min = std::numeric_limits<T>::min();
-  T max = std::numeric_limits<T>::max();
-  if (val < static_cast<int64_t>(min) || val > static_cast<int64_t>(max)) {
-    throw std::out_of_range("Value out of range");
+// Parses a decimal integer within [min, max]. The bounds are checked while
+// the digits accumulate, so an out-of-range value is rejected as soon as its
+// magnitude exceeds the limit instead of after a full conversion.
+template <Integer T>
+  requires(!std::same_as<T, bool>)
+constexpr auto parseInteger(std::string_view str, T min, T max) -> T {
+  std::size_t pos = 0;
+  const bool negative = !str.empty() && str[0] == '-';
+  if (!str.empty() && (str[0] == '-' || str[0] == '+')) {
+    ++pos;
+  }
+  if (pos == str.size()) {
+    detail::raise<std::invalid_argument>("Invalid integer value");
+  }
+  // Largest magnitude reachable in the direction of the sign
+  uint64_t limit = 0;
+  if (negative && min < 0) {
+    limit = static_cast<uint64_t>(-(static_cast<int64_t>(min) + 1)) + 1;
+  } else if (!negative && max > 0) {
+    limit = static_cast<uint64_t>(max);
+  }
+  constexpr uint64_t base = 10;
+  uint64_t magnitude = 0;
+  for (; pos < str.size(); ++pos) {
+    const char c = str[pos];
+    if (c < '0' || c > '9') {
+      detail::raise<std::invalid_argument>("Invalid integer value");
+    }
+    const auto digit = static_cast<uint64_t>(c - '0');
+    if (magnitude > limit / base ||
+        (magnitude == limit / base && digit > limit % base)) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+    magnitude = magnitude * base + digit;
   }
-  return static_cast<T>(val);
+  T value{};
+  if constexpr (SignedInteger<T>) {
+    // Negated via magnitude - 1 so the most negative value does not overflow
+    value = negative ? static_cast<T>(-static_cast<int64_t>(magnitude - 1) - 1)
+                     : static_cast<T>(magnitude);
+  } else {
+    value = static_cast<T>(magnitude);
+  }
+  if (value < min || value > max) {
+    detail::raise<std::out_of_range>("Value out of range");
+  }
+  return value;
 }
 
-template <UnsignedInteger T>
-constexpr auto fromStrUnsigInt(const char* str) -> T {
-  uint64_t val = std::stoull(str);
-  T max = std::numeric_limits<T>::max();
-  if (val > static_cast<uint64_t>(max)) {
-    throw std::out_of_range("Value out of range");
+// Converts the whole of `str` with from_chars, which neither allocates nor
+// depends on the locale, unlike std::stod
+template <std::floating_point T>
+auto fromViewFloat(std::string_view str) -> T {
+  T value{};
+  const char* first = str.data();
+  const char* last = str.data() + str.size();
+  if (first != last && *first == '+') {
+    ++first;
+  }
+  const auto [ptr, ec] = std::from_chars(first, last, value);
+  if (ec == std::errc::result_out_of_range) {
+    detail::raise<std::out_of_range>("Value out of range");
+  }
+  if (ec != std::errc{} || ptr != last) {
+    detail::raise<std::invalid_argument>("Invalid floating point value");
   }
-  return static_cast<T>(val);
+  return value;
 }
 
 }  // namespace detail
@@ -53,12 +105,13 @@ constexpr auto fromStrUnsigInt(const char* str) -> T {
 template <detail::Integer T>
 auto fromStr(const char* str) -> T {
   if (!str) {
-    throw std::invalid_argument("Null pointer passed to fromStr");
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
   }
-  if constexpr (detail::SignedInteger<T>) {
-    return detail::fromStrSigInt<T>(str);
-  } else if constexpr (detail::UnsignedInteger<T>) {
-    return detail::fromStrUnsigInt<T>(str);
+  if constexpr (std::same_as<T, bool>) {
+    return detail::parseInteger<uint8_t>(str, 0, 1) != 0;
+  } else {
+    return detail::parseInteger<T>(str, std::numeric_limits<T>::min(),
+                                   std::numeric_limits<T>::max());
   }
 }
 
@@ -66,17 +119,19 @@ auto fromStr(const char* str) -> T {
 template <>
 inline auto fromStr<double>(const char* str) -> double {
   if (!str) {
-    throw std::invalid_argument("Null pointer passed to fromStr<double>");
+    detail::raise<std::invalid_argument>(
+        "Null pointer passed to fromStr<double>");
   }
-  return std::stod(str);
+  return detail::fromViewFloat<double>(str);
 }
 
 template <>
 inline auto fromStr<float>(const char* str) -> float {
   if (!str) {
-    throw std::invalid_argument("Null pointer passed to fromStr<float>");
+    detail::raise<std::invalid_argument>(
+        "Null pointer passed to fromStr<float>");
   }
-  return std::stof(str);
+  return detail::fromViewFloat<float>(str);
 }
 
 // String specializations
@@ -94,7 +149,7 @@ inline auto fromStr<std::string_view>(const char* str) -> std::string_view {
 template <>
 inline auto fromStr<char>(const char* str) -> char {
   if (str == nullptr || str[0] == '\0' || str[1] != '\0') {
-    throw std::invalid_argument("Invalid char value");
+    detail::raise<std::invalid_argument>("Invalid char value");
   }
   return str[0];
 }
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "converters.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_COUNTS_HPP
+#define ETCHED_COUNTS_HPP
+
+namespace etched {
+
+namespace detail {
+
+// Smallest unsigned type holding Max
+template <uint64_t Max>
+using CountStorage = std::conditional_t<
+    Max <= UINT8_MAX, uint8_t,
+    std::conditional_t<Max <= UINT16_MAX, uint16_t,
+                       std::conditional_t<Max <= UINT32_MAX, uint32_t,
+                                          uint64_t>>>;
+
+}  // namespace detail
+
+// Number of times a flag occurred, as in -vvv or -v -v -v, saturating at Max
+template <uint64_t Max = UINT8_MAX>
+  requires(Max > 0)
+class Count {
+ public:
+  using UnderlyingType = detail::CountStorage<Max>;
+  static constexpr UnderlyingType max = Max;
+
+  constexpr Count(UnderlyingType value = 0) : value_(value) {  // NOLINT
+    if (value > Max) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+  }
+
+  constexpr operator UnderlyingType() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> UnderlyingType { return value_; }
+
+  // Counts one occurrence; the flag takes no value
+  static constexpr auto increment(std::optional<Count>& current) -> void {
+    const UnderlyingType value = current ? current->value_ : 0;
+    current = Count(value < Max ? value + 1 : value);
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "(repeatable, max " << +max << ")";
+  }
+
+ private:
+  UnderlyingType value_;
+};
+
+namespace detail {
+
+template <typename T>
+struct IsCountType : std::false_type {};
+
+template <uint64_t Max>
+struct IsCountType<Count<Max>> : std::true_type {};
+
+template <typename T>
+concept CountValue = IsCountType<T>::value;
+
+}  // namespace detail
+
+// Explicit counts, e.g. a default or a value from the environment
+template <detail::CountValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  using U = typename T::UnderlyingType;
+  return T(detail::parseInteger<U>(str, 0, T::max));
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_COUNTS_HPP
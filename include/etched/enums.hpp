@@ -0,0 +1,120 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "errors.hpp"
+#include "lookup.hpp"
+
+#ifndef ETCHED_ENUMS_HPP
+#define ETCHED_ENUMS_HPP
+
+namespace etched {
+
+namespace detail {
+
+// One {"name", E::value} entry of an enum option
+template <typename E, std::size_t N>
+  requires std::is_enum_v<E>
+struct EnumPair {
+  using EnumType = E;
+
+  std::array<char, N> name;
+  E value;
+
+  consteval EnumPair(const char (&str)[N], E enumValue)  // NOLINT
+      : name{}, value(enumValue) {
+    std::copy_n(str, N, name.data());
+  }
+
+  [[nodiscard]] constexpr auto view() const -> std::string_view {
+    return {name.data(), N - 1};
+  }
+};
+
+template <typename E, std::size_t N>
+EnumPair(const char (&)[N], E) -> EnumPair<E, N>;  // NOLINT
+
+}  // namespace detail
+
+// Enumerator chosen by name from a compile-time list, e.g.
+// EnumValue<Codec, {"none", Codec::NONE}, {"lz4", Codec::LZ4}>
+template <typename E, detail::EnumPair... Pairs>
+  requires std::is_enum_v<E> && (sizeof...(Pairs) > 0) &&
+           (sizeof...(Pairs) < UINT8_MAX) &&
+           (std::same_as<typename decltype(Pairs)::EnumType, E> && ...)
+class EnumValue {
+ public:
+  using UnderlyingType = E;
+  static constexpr std::size_t count = sizeof...(Pairs);
+  static constexpr std::array<std::string_view, count> names = {
+      Pairs.view()...};
+  static constexpr std::array<E, count> values = {Pairs.value...};
+  static constexpr auto table = detail::HashedNameTable<count>::build(names);
+
+  constexpr EnumValue(E value) : value_(value) {  // NOLINT
+    if (std::find(values.begin(), values.end(), value) == values.end()) {
+      detail::raise<std::out_of_range>("Enumerator not in allowed set");
+    }
+  }
+
+  constexpr operator E() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> E { return value_; }
+
+  // Name of the first entry mapping to the stored enumerator
+  [[nodiscard]] constexpr auto name() const -> std::string_view {
+    return names[static_cast<std::size_t>(
+        std::find(values.begin(), values.end(), value_) - values.begin())];
+  }
+
+  static constexpr auto fromName(std::string_view name) -> EnumValue {
+    const std::size_t idx = table.find(names, name);
+    if (idx == detail::HashedNameTable<count>::npos) {
+      detail::raise<std::out_of_range>("Value not in allowed set");
+    }
+    return EnumValue(values[idx]);
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "{" << names[0];
+    for (std::size_t i = 1; i < count; ++i) {
+      os << "|" << names[i];
+    }
+    os << "}";
+  }
+
+ private:
+  E value_;
+};
+
+namespace detail {
+
+template <typename T>
+struct IsEnumValue : std::false_type {};
+
+template <typename E, EnumPair... Pairs>
+struct IsEnumValue<EnumValue<E, Pairs...>> : std::true_type {};
+
+template <typename T>
+concept EnumValueType = IsEnumValue<T>::value;
+
+}  // namespace detail
+
+template <detail::EnumValueType T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  return T::fromName(str);
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_ENUMS_HPP
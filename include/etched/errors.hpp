@@ -0,0 +1,99 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#ifndef ETCHED_ERRORS_HPP
+#define ETCHED_ERRORS_HPP
+
+// 1 when the library reports runtime errors by throwing, 0 when built with
+// -fno-exceptions, where they go to the handler set by setErrorHandler()
+#ifndef ETCHED_EXCEPTIONS
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define ETCHED_EXCEPTIONS 1
+#else
+#define ETCHED_EXCEPTIONS 0
+#endif
+#endif
+
+namespace etched {
+
+// Exception type a runtime error would be thrown as
+enum class ErrorKind : std::uint8_t {
+  INVALID_ARGUMENT,
+  OUT_OF_RANGE,
+  SYSTEM,
+  // Misuse of the API rather than bad input, e.g. a second parse()
+  LOGIC
+};
+
+// Receives runtime errors when exceptions are disabled. It must not return,
+// e.g. log and exit; the library aborts if it does.
+using ErrorHandler = void (*)(ErrorKind kind, const char* message);
+
+namespace detail {
+
+inline auto defaultErrorHandler(ErrorKind /*unused*/, const char* message)
+    -> void {
+  std::fputs("etched: ", stderr);
+  std::fputs(message, stderr);
+  std::fputs("\n", stderr);
+  std::abort();
+}
+
+inline std::atomic<ErrorHandler> errorHandler{defaultErrorHandler};
+
+[[noreturn]] inline auto handleError(ErrorKind kind, const char* message)
+    -> void {
+  errorHandler.load(std::memory_order_acquire)(kind, message);
+  std::abort();
+}
+
+template <typename Exception>
+constexpr auto errorKind() -> ErrorKind {
+  if constexpr (std::is_same_v<Exception, std::out_of_range>) {
+    return ErrorKind::OUT_OF_RANGE;
+  } else if constexpr (std::is_same_v<Exception, std::system_error>) {
+    return ErrorKind::SYSTEM;
+  } else if constexpr (std::is_same_v<Exception, std::logic_error>) {
+    return ErrorKind::LOGIC;
+  } else {
+    return ErrorKind::INVALID_ARGUMENT;
+  }
+}
+
+// Reports an error: throws Exception, or without exceptions calls the error
+// handler. Neither is a constant expression, so a failed consteval
+// validation still stops the build at the call that reported it.
+template <typename Exception>
+[[noreturn]] constexpr auto raise(const char* message) -> void {
+#if ETCHED_EXCEPTIONS
+  throw Exception(message);
+#else
+  handleError(errorKind<Exception>(), message);
+#endif
+}
+
+template <typename Exception>
+[[noreturn]] auto raise(const std::string& message) -> void {
+  raise<Exception>(message.c_str());
+}
+
+}  // namespace detail
+
+// Installs the handler for runtime errors in builds without exceptions and
+// returns the previous one. Ignored when exceptions are enabled.
+inline auto setErrorHandler(ErrorHandler handler) -> ErrorHandler {
+  return detail::errorHandler.exchange(
+      handler != nullptr ? handler : detail::defaultErrorHandler,
+      std::memory_order_acq_rel);
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_ERRORS_HPP
@@ -4,13 +4,35 @@
 #define ETCHED_LIB_HPP
 
 #include "etched/argument_parser.hpp"
+#include "etched/bounded.hpp"
+#include "etched/completion.hpp"
+#include "etched/composite.hpp"
 #include "etched/concepts.hpp"
+#include "etched/constraints.hpp"
 #include "etched/converters.hpp"
+#include "etched/counts.hpp"
+#include "etched/enums.hpp"
+#include "etched/errors.hpp"
+#include "etched/features.hpp"
+#include "etched/files.hpp"
+#include "etched/global.hpp"
 #include "etched/helpers.hpp"
+#include "etched/incremental.hpp"
+#include "etched/keyvalues.hpp"
+#include "etched/lists.hpp"
+#include "etched/lookup.hpp"
 #include "etched/option.hpp"
+#include "etched/parse_state.hpp"
 #include "etched/parsers.hpp"
+#include "etched/reload.hpp"
 #include "etched/sanitizers.hpp"
+#include "etched/snapshot.hpp"
+#include "etched/stream.hpp"
 #include "etched/strings.hpp"
+#include "etched/suggestions.hpp"
+#include "etched/table.hpp"
+#include "etched/trace.hpp"
+#include "etched/units.hpp"
 
 namespace etched {
 
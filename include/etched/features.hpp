@@ -0,0 +1,144 @@
+#pragma once
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "composite.hpp"
+#include "errors.hpp"
+#include "lookup.hpp"
+#include "strings.hpp"
+
+#ifndef ETCHED_FEATURES_HPP
+#define ETCHED_FEATURES_HPP
+
+namespace etched {
+
+// Set of named feature gates, e.g. FeatureSet<"simd", "gpu", "trace">,
+// parsed from lists such as "simd,gpu,-trace". Names are hashed into a
+// compile-time table and the list is scanned once without allocating.
+// Repeated occurrences edit the current set: plain or '+' names are added,
+// '-' names removed.
+template <detail::String... Names>
+  requires(sizeof...(Names) > 0 && sizeof...(Names) < UINT8_MAX)
+class FeatureSet {
+ public:
+  static constexpr std::size_t count = sizeof...(Names);
+  static constexpr std::array<std::string_view, count> names = {
+      Names.view()...};
+  static constexpr auto table = detail::HashedNameTable<count>::build(names);
+
+  constexpr FeatureSet() = default;
+
+  constexpr explicit FeatureSet(std::string_view list) { apply(list); }
+
+  constexpr auto apply(std::string_view list) -> void {
+    for (std::string_view item : Tokenizer<','>(list)) {
+      bool enable = true;
+      if (!item.empty() && (item[0] == '-' || item[0] == '+')) {
+        enable = item[0] == '+';
+        item.remove_prefix(1);
+      }
+      const std::size_t idx = table.find(names, item);
+      if (idx == detail::HashedNameTable<count>::npos) {
+        detail::raise<std::invalid_argument>("Unknown feature name");
+      }
+      set(idx, enable);
+    }
+  }
+
+  constexpr auto set(std::size_t idx, bool enable) -> void {
+    const uint64_t bit = uint64_t{1} << (idx % wordBits);
+    words_[idx / wordBits] =
+        enable ? (words_[idx / wordBits] | bit) : (words_[idx / wordBits] & ~bit);
+  }
+
+  [[nodiscard]] constexpr auto test(std::size_t idx) const -> bool {
+    return ((words_[idx / wordBits] >> (idx % wordBits)) & 1U) != 0;
+  }
+
+  // Checks a feature by name; unknown names fail to compile
+  template <detail::String Name>
+  [[nodiscard]] constexpr auto has() const -> bool {
+    constexpr std::size_t idx = indexOf(Name.view());
+    return test(idx);
+  }
+
+  [[nodiscard]] auto bits() const -> std::bitset<count> {
+    std::bitset<count> result;
+    for (std::size_t i = 0; i < count; ++i) {
+      result[i] = test(i);
+    }
+    return result;
+  }
+
+  [[nodiscard]] constexpr auto mask() const -> uint64_t
+    requires(count <= 64)
+  {
+    return words_[0];
+  }
+
+  constexpr auto operator==(const FeatureSet& other) const -> bool = default;
+
+  static constexpr auto accumulate(std::optional<FeatureSet>& current,
+                                   const char* str) -> void {
+    if (!str) {
+      detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+    }
+    FeatureSet edited = current.value_or(FeatureSet{});
+    edited.apply(str);
+    current = edited;
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "[-]{" << names[0];
+    for (std::size_t i = 1; i < count; ++i) {
+      os << "|" << names[i];
+    }
+    os << "},...";
+  }
+
+ private:
+  static constexpr std::size_t wordBits = 64;
+
+  std::array<uint64_t, (count + wordBits - 1) / wordBits> words_{};
+
+  static consteval auto indexOf(std::string_view name) -> std::size_t {
+    for (std::size_t i = 0; i < count; ++i) {
+      if (names[i] == name) {
+        return i;
+      }
+    }
+    detail::raise<std::invalid_argument>("Unknown feature name");
+  }
+};
+
+namespace detail {
+
+template <typename T>
+struct IsFeatureSet : std::false_type {};
+
+template <String... Names>
+struct IsFeatureSet<FeatureSet<Names...>> : std::true_type {};
+
+template <typename T>
+concept FeatureSetValue = IsFeatureSet<T>::value;
+
+}  // namespace detail
+
+template <detail::FeatureSetValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  return T(std::string_view(str));
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_FEATURES_HPP
@@ -0,0 +1,199 @@
+#pragma once
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ETCHED_HAS_MMAP 1
+#else
+#include <sys/stat.h>
+#define ETCHED_HAS_MMAP 0
+#endif
+
+#include "concepts.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_FILES_HPP
+#define ETCHED_FILES_HPP
+
+namespace etched {
+
+// Read-only contents of the file named by the argument, given as "path" or
+// "@path". The file is checked to exist while parsing but only mapped on the
+// first access to its bytes; the mapping lives as long as the value, which
+// the parser owns. Copies share nothing and map the file again on access.
+// Mapping is not synchronized: access the contents once, or call the
+// parser's validateAll(), before sharing the value across threads.
+class FileContents {
+ public:
+  constexpr explicit FileContents(const char* path) : path_(path) {
+    if (path_ != nullptr && path_[0] == '@') {
+      ++path_;
+    }
+  }
+
+  constexpr FileContents(const FileContents& other) : path_(other.path_) {}
+
+  constexpr FileContents(FileContents&& other) noexcept
+      : path_(other.path_),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        owned_(std::exchange(other.owned_, false)) {}
+
+  constexpr auto operator=(const FileContents& other) -> FileContents& {
+    if (this != &other) {
+      release();
+      path_ = other.path_;
+    }
+    return *this;
+  }
+
+  constexpr auto operator=(FileContents&& other) noexcept -> FileContents& {
+    if (this != &other) {
+      release();
+      path_ = other.path_;
+      data_ = std::exchange(other.data_, nullptr);
+      size_ = std::exchange(other.size_, 0);
+      owned_ = std::exchange(other.owned_, false);
+    }
+    return *this;
+  }
+
+  constexpr ~FileContents() { release(); }
+
+  [[nodiscard]] constexpr auto path() const -> const char* { return path_; }
+
+  [[nodiscard]] constexpr auto mapped() const -> bool {
+    return data_ != nullptr;
+  }
+
+  [[nodiscard]] auto view() const -> std::string_view {
+    map();
+    return {data_, size_};
+  }
+
+  [[nodiscard]] auto bytes() const -> std::span<const std::byte> {
+    map();
+    return {reinterpret_cast<const std::byte*>(data_), size_};  // NOLINT
+  }
+
+  [[nodiscard]] auto size() const -> std::size_t {
+    map();
+    return size_;
+  }
+
+  operator std::string_view() const { return view(); }  // NOLINT
+
+  static auto printValueHint(std::ostream& os) -> void { os << "[@]path"; }
+
+ private:
+  const char* path_;
+  mutable const char* data_ = nullptr;
+  mutable std::size_t size_ = 0;
+  mutable bool owned_ = false;
+
+  [[noreturn]] auto fail() const -> void {
+#if ETCHED_EXCEPTIONS
+    throw std::system_error(errno, std::generic_category(),
+                            std::string("Cannot read file: ") + path_);
+#else
+    detail::raise<std::system_error>(
+        std::string("Cannot read file: ") + path_ + ": " +
+        std::strerror(errno));
+#endif
+  }
+
+  auto map() const -> void {
+    if (data_ != nullptr) {
+      return;
+    }
+#if ETCHED_HAS_MMAP
+    const int fd = ::open(path_, O_RDONLY | O_CLOEXEC);  // NOLINT
+    if (fd < 0) {
+      fail();
+    }
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+      ::close(fd);
+      fail();
+    }
+    const auto length = static_cast<std::size_t>(info.st_size);
+    if (length == 0) {
+      ::close(fd);
+      data_ = "";
+      return;
+    }
+    void* addr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {  // NOLINT
+      fail();
+    }
+    data_ = static_cast<const char*>(addr);
+    size_ = length;
+    owned_ = true;
+#else
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(
+        std::fopen(path_, "rb"), &std::fclose);
+    if (!file) {
+      fail();
+    }
+    std::string contents;
+    char chunk[4096];  // NOLINT
+    std::size_t read = 0;
+    while ((read = std::fread(chunk, 1, sizeof(chunk), file.get())) > 0) {
+      contents.append(chunk, read);
+    }
+    auto* buffer = new char[contents.size() + 1];
+    contents.copy(buffer, contents.size());
+    buffer[contents.size()] = '\0';
+    data_ = buffer;
+    size_ = contents.size();
+    owned_ = true;
+#endif
+  }
+
+  constexpr auto release() -> void {
+    if (!std::is_constant_evaluated() && owned_) {
+#if ETCHED_HAS_MMAP
+      ::munmap(const_cast<char*>(data_), size_);  // NOLINT
+#else
+      delete[] data_;
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    owned_ = false;
+  }
+};
+
+template <>
+inline auto fromStr<FileContents>(const char* str) -> FileContents {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  FileContents contents(str);
+  struct stat info {};
+  if (::stat(contents.path(), &info) != 0 || !S_ISREG(info.st_mode)) {
+    detail::raise<std::invalid_argument>(
+        std::string("Not a readable file: ") + contents.path());
+  }
+  return contents;
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_FILES_HPP
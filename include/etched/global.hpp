@@ -0,0 +1,93 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include "errors.hpp"
+#include "strings.hpp"
+
+#ifndef ETCHED_GLOBAL_HPP
+#define ETCHED_GLOBAL_HPP
+
+namespace etched {
+
+// Parser meant for a constinit variable at namespace scope, so it is built
+// at compile time with no static initialization order to worry about:
+//
+//   constinit etched::GlobalParser options{etched::ArgumentParser(...)};
+//
+// main() calls parse() once; the values are then published with a release
+// store and any thread can read them after one acquire load, without locks
+// or function-local static guards.
+template <typename Parser>
+class GlobalParser {
+ public:
+  consteval explicit GlobalParser(Parser parser) : parser_(parser) {}
+
+  GlobalParser(const GlobalParser&) = delete;
+  auto operator=(const GlobalParser&) -> GlobalParser& = delete;
+
+  // Parses and publishes the values. Only one call may succeed; a failed
+  // parse leaves the parser unpublished and unchanged so it can be retried.
+  auto parse(const int argc, const char* argv[]) -> void {  // NOLINT
+    std::uint8_t expected = unparsed;
+    if (!state_.compare_exchange_strong(expected, parsing,
+                                        std::memory_order_acquire)) {
+      detail::raise<std::logic_error>("Global options parsed twice");
+    }
+    // Resets the state if parsing throws
+    struct Rollback {
+      std::atomic<std::uint8_t>& state;
+      bool done = false;
+
+      ~Rollback() {
+        if (!done) {
+          state.store(unparsed, std::memory_order_release);
+        }
+      }
+    } rollback{state_};
+    // Parsed into a copy so that a failed attempt leaves no values behind
+    Parser attempt = parser_;
+    attempt.parse(argc, argv);
+    // Converted and mapped now so that readers never write to the parser
+    attempt.validateAll();
+    parser_ = std::move(attempt);
+    rollback.done = true;
+    state_.store(published, std::memory_order_release);
+  }
+
+  [[nodiscard]] auto ready() const -> bool {
+    return state_.load(std::memory_order_acquire) == published;
+  }
+
+  template <detail::String Tag>
+  [[nodiscard]] auto getOption() const -> const auto& {
+    return parser().template getOption<Tag>();
+  }
+
+  template <detail::String Tag>
+  [[nodiscard]] auto given() const -> bool {
+    return parser().template given<Tag>();
+  }
+
+  // The published parser; reading before parse() has returned is an error
+  [[nodiscard]] auto parser() const -> const Parser& {
+    if (!ready()) {
+      detail::raise<std::logic_error>("Global options read before parse()");
+    }
+    return parser_;
+  }
+
+ private:
+  static constexpr std::uint8_t unparsed = 0;
+  static constexpr std::uint8_t parsing = 1;
+  static constexpr std::uint8_t published = 2;
+
+  Parser parser_;
+  std::atomic<std::uint8_t> state_{unparsed};
+};
+
+}  // namespace etched
+
+#endif  // ETCHED_GLOBAL_HPP
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <stdexcept>
@@ -6,6 +8,13 @@
 #include <type_traits>
 
 #include "converters.hpp"
+#include "counts.hpp"
+#include "enums.hpp"
+#include "errors.hpp"
+#include "features.hpp"
+#include "files.hpp"
+#include "keyvalues.hpp"
+#include "lists.hpp"
 #include "option.hpp"
 #include "strings.hpp"
 
@@ -28,7 +37,7 @@ consteval auto opt(
   std::optional<const char*> descriptionChecked =
       (description && description.has_value()) ? description : std::nullopt;
   if (!shortName && !longName) {
-    throw std::invalid_argument(
+    detail::raise<std::invalid_argument>(
         "At least one of shortName or longName must be provided");
   }
   return detail::Option<T, detail::trim<Tag>()>{
@@ -81,13 +90,86 @@ consteval auto optFloat(
   return opt<T, Tag>(shortName, longName, description, defaultValue);
 }
 
+// Flag counted on each occurrence, e.g. optCount<"verbose", 3>("-v") so that
+// -vvv yields 3. Counts above Max saturate; absent flags count 0.
+template <detail::String Tag, uint64_t Max = UINT8_MAX>
+consteval auto optCount(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt) {
+  return opt<Count<Max>, Tag>(shortName, longName, description, Count<Max>{});
+}
+
+// Enum option over a compile-time name list, e.g.
+// optEnum<"codec", Codec, {"none", Codec::NONE}, {"lz4", Codec::LZ4}>(...)
+template <detail::String Tag, typename E, detail::EnumPair... Pairs>
+  requires std::is_enum_v<E>
+consteval auto optEnum(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt,  // NOLINT
+    std::optional<E> defaultValue = std::nullopt) {
+  using ValueType = EnumValue<E, Pairs...>;
+  std::optional<ValueType> defaultChecked =
+      defaultValue ? std::optional<ValueType>(ValueType(defaultValue.value()))
+                   : std::nullopt;
+  return opt<ValueType, Tag>(shortName, longName, description, defaultChecked);
+}
+
+// Feature-gate option, e.g.
+// optFeatures<"features", "simd", "gpu">("-f", "--features", "Gates", "simd")
+template <detail::String Tag, detail::String... Names>
+consteval auto optFeatures(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt,  // NOLINT
+    std::optional<const char*> defaultList = std::nullopt) {
+  using ValueType = FeatureSet<Names...>;
+  std::optional<ValueType> defaultChecked =
+      defaultList ? std::optional<ValueType>(ValueType(defaultList.value()))
+                  : std::nullopt;
+  return opt<ValueType, Tag>(shortName, longName, description, defaultChecked);
+}
+
+// File whose contents are mapped on first access, given as path or @path
+template <detail::String Tag>
+consteval auto optFile(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt) {
+  return opt<FileContents, Tag>(shortName, longName, description);
+}
+
+// Delimited list, e.g. optList<"ids", int64_t>("-i", "--ids", "IDs") for
+// --ids=1,2,3; repeated occurrences append
+template <detail::String Tag, typename T, char Delim = ','>
+consteval auto optList(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt) {
+  return opt<List<T, Delim>, Tag>(shortName, longName, description,
+                                  List<T, Delim>{});
+}
+
+// Repeatable key=value settings, e.g. optMap<"set">("-D", "--set", "Override")
+template <detail::String Tag, std::size_t Capacity = 16>
+consteval auto optMap(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt) {
+  return opt<KeyValueMap<Capacity>, Tag>(shortName, longName, description,
+                                         KeyValueMap<Capacity>{});
+}
+
+// Flag whose callback runs once the command line has parsed; callbacks run
+// in ascending priority, then declaration order
 template <detail::String Tag, typename CallbackType>
   requires ISCallback<CallbackType>
 consteval auto optCallback(
     std::optional<const char*> shortName = std::nullopt,    // NOLINT
     std::optional<const char*> longName = std::nullopt,     // NOLINT
     std::optional<const char*> description = std::nullopt,  // NOLINT
-    CallbackType callback = nullptr) {
+    CallbackType callback = nullptr, int priority = 0) {
   std::optional<const char*> shortNameChecked =
       (shortName && shortName.value()) ? shortName : std::nullopt;
   std::optional<const char*> longNameChecked =
@@ -95,7 +177,7 @@ consteval auto optCallback(
   std::optional<const char*> descriptionChecked =
       (description && description.value()) ? description : std::nullopt;
   if (!shortName && !longName) {
-    throw std::invalid_argument(
+    detail::raise<std::invalid_argument>(
         "At least one of shortName or longName must be provided");
   }
   return detail::OptionWithCallback<bool, detail::trim<Tag>(), CallbackType>{
@@ -105,6 +187,37 @@ consteval auto optCallback(
       .longName = longNameChecked,
       .description = descriptionChecked,
       .defaultValue = std::nullopt,
+      .priority = priority,
+  };
+}
+
+// Option whose callback receives the converted value, e.g.
+// optCallback<"log", std::string_view>("-l", "--log", "Log file", openLog)
+template <detail::String Tag, typename T, typename CallbackType>
+  requires std::is_invocable_v<CallbackType, const T&>
+consteval auto optCallback(
+    std::optional<const char*> shortName = std::nullopt,    // NOLINT
+    std::optional<const char*> longName = std::nullopt,     // NOLINT
+    std::optional<const char*> description = std::nullopt,  // NOLINT
+    CallbackType callback = nullptr, int priority = 0) {
+  std::optional<const char*> shortNameChecked =
+      (shortName && shortName.value()) ? shortName : std::nullopt;
+  std::optional<const char*> longNameChecked =
+      (longName && longName.value()) ? longName : std::nullopt;
+  std::optional<const char*> descriptionChecked =
+      (description && description.value()) ? description : std::nullopt;
+  if (!shortName && !longName) {
+    detail::raise<std::invalid_argument>(
+        "At least one of shortName or longName must be provided");
+  }
+  return detail::OptionWithCallback<T, detail::trim<Tag>(), CallbackType>{
+      .callback = callback,
+      .value = std::nullopt,
+      .shortName = shortNameChecked,
+      .longName = longNameChecked,
+      .description = descriptionChecked,
+      .defaultValue = std::nullopt,
+      .priority = priority,
   };
 }
 
@@ -128,7 +241,7 @@ consteval auto optVersion(
       (description && (description.value() != nullptr)) ? description
                                                         : std::nullopt;
   if (!shortName && !longName) {
-    throw std::invalid_argument(
+    detail::raise<std::invalid_argument>(
         "At least one of shortName or longName must be provided");
   }
   auto callback = [versionString]() -> void {
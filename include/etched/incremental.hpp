@@ -0,0 +1,260 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "errors.hpp"
+#include "parse_state.hpp"
+
+#ifndef ETCHED_INCREMENTAL_HPP
+#define ETCHED_INCREMENTAL_HPP
+
+namespace etched {
+
+// An option or positional argument completed by an IncrementalParse
+struct ParseEvent {
+  static constexpr std::size_t positional = SIZE_MAX;
+
+  // Declaration index of the option, or `positional`
+  std::size_t option = positional;
+  // The option's value, empty for flags, or the positional argument
+  std::string_view text;
+};
+
+namespace detail {
+
+// Suspends the parse coroutine until the caller pushes a token
+struct TokenRequest {};
+
+// Gives the parse coroutine its promise without suspending
+struct PromiseRequest {};
+
+// Coroutine behind IncrementalParse. It waits for a token with
+// co_await TokenRequest{}, which gives null once input has ended, and
+// co_yields a ParseEvent for everything the token completed.
+class ParseTask {
+ public:
+  struct promise_type {
+    const char* token = nullptr;
+    ParseEvent event{};
+    bool hasEvent = false;
+    // Option whose value will be the next token, if any
+    std::optional<std::size_t> awaiting;
+    // Value text per option, kept with the coroutine frame so values stay
+    // valid after the parse has returned
+    std::vector<std::vector<char>> retained;
+    // Every value of accumulating options, which build on earlier ones
+    std::vector<std::vector<char>> kept;
+    // Options completed by the current token
+    std::vector<ParseEvent> completed;
+#if ETCHED_EXCEPTIONS
+    std::exception_ptr error;
+#endif
+
+    auto get_return_object() -> ParseTask {
+      return ParseTask(
+          std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+
+    static auto initial_suspend() noexcept -> std::suspend_always {
+      return {};
+    }
+
+    static auto final_suspend() noexcept -> std::suspend_always { return {}; }
+
+    auto yield_value(ParseEvent next) noexcept -> std::suspend_always {
+      event = next;
+      hasEvent = true;
+      return {};
+    }
+
+    // Replaces the text kept for option idx and returns the copy
+    auto retain(std::size_t idx, const char* text) -> const char* {
+      auto& slot = retained[idx];
+      slot.assign(text, text + std::strlen(text) + 1);
+      return slot.data();
+    }
+
+    // Adds a copy of a value of an accumulating option and returns it
+    auto keep(const char* text) -> const char* {
+      return kept.emplace_back(text, text + std::strlen(text) + 1).data();
+    }
+
+    // Hooks of the parse: values are copied into the promise, and each
+    // option applied is recorded in `completed`
+    auto hooks() -> ValueHooks {
+      return ValueHooks{
+          .context = this,
+          .retain = [](void* ctx, std::size_t idx,
+                       const char* value) -> const char* {
+            return static_cast<promise_type*>(ctx)->retain(idx, value);
+          },
+          .keep = [](void* ctx, std::size_t /*unused*/,
+                     const char* value) -> const char* {
+            return static_cast<promise_type*>(ctx)->keep(value);
+          },
+          .applied = [](void* ctx, std::size_t idx,
+                        const char* value) -> void {
+            static_cast<promise_type*>(ctx)->completed.push_back(ParseEvent{
+                .option = idx, .text = value != nullptr ? value : ""});
+          }};
+    }
+
+    auto await_transform(TokenRequest /*unused*/) noexcept {
+      struct Awaiter {
+        promise_type& promise;
+
+        static auto await_ready() noexcept -> bool { return false; }
+
+        static auto await_suspend(
+            std::coroutine_handle<> /*unused*/) noexcept -> void {}
+
+        [[nodiscard]] auto await_resume() const noexcept -> const char* {
+          return promise.token;
+        }
+      };
+      return Awaiter{*this};
+    }
+
+    auto await_transform(PromiseRequest /*unused*/) noexcept {
+      struct Awaiter {
+        promise_type& promise;
+
+        static auto await_ready() noexcept -> bool { return true; }
+
+        static auto await_suspend(
+            std::coroutine_handle<> /*unused*/) noexcept -> void {}
+
+        [[nodiscard]] auto await_resume() const noexcept -> promise_type& {
+          return promise;
+        }
+      };
+      return Awaiter{*this};
+    }
+
+    static auto return_void() noexcept -> void {}
+
+    auto unhandled_exception() noexcept -> void {
+#if ETCHED_EXCEPTIONS
+      error = std::current_exception();
+#else
+      std::abort();
+#endif
+    }
+  };
+
+  using Handle = std::coroutine_handle<promise_type>;
+
+  explicit ParseTask(Handle handle) : handle_(handle) {}
+
+  ParseTask(const ParseTask&) = delete;
+  ParseTask(ParseTask&& other) noexcept
+      : handle_(std::exchange(other.handle_, nullptr)) {}
+  auto operator=(const ParseTask&) -> ParseTask& = delete;
+  auto operator=(ParseTask&& other) noexcept -> ParseTask& {
+    std::swap(handle_, other.handle_);
+    return *this;
+  }
+
+  ~ParseTask() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  [[nodiscard]] auto handle() const -> Handle { return handle_; }
+
+ private:
+  Handle handle_;
+};
+
+}  // namespace detail
+
+// Parses a command line pushed one token at a time, e.g. as a control
+// protocol receives it. The parse runs as a coroutine that keeps its state,
+// including an option still waiting for its value, between tokens:
+//
+//   auto session = mutableParser.incremental();
+//   session.push("--jobs");
+//   session.push("4");
+//   while (auto event = session.next()) { ... }
+//   session.finish();
+//
+// Positional arguments are reported but not kept, and view the token they
+// came from until the next push(). Option values, including every value of
+// a repeatable option, view text owned by the session, which must outlive
+// them.
+class IncrementalParse {
+ public:
+  explicit IncrementalParse(detail::ParseTask task) : task_(std::move(task)) {
+    resume();
+  }
+
+  // Parses the next token, dropping events not read with next()
+  auto push(const char* token) -> void {
+    if (token == nullptr) {
+      detail::raise<std::invalid_argument>("Null token pushed");
+    }
+    feed(token);
+  }
+
+  // Next event completed by the tokens pushed so far, or nullopt
+  auto next() -> std::optional<ParseEvent> {
+    auto& promise = task_.handle().promise();
+    if (!promise.hasEvent) {
+      return std::nullopt;
+    }
+    const ParseEvent event = promise.event;
+    resume();
+    return event;
+  }
+
+  // Declaration index of the option the next token will be the value of
+  [[nodiscard]] auto awaiting() const -> std::optional<std::size_t> {
+    return task_.handle().promise().awaiting;
+  }
+
+  // Ends the input: rejects an option still missing its value, then checks
+  // constraints and runs callbacks as parse() does
+  auto finish() -> void { feed(nullptr); }
+
+  [[nodiscard]] auto finished() const -> bool { return task_.handle().done(); }
+
+ private:
+  detail::ParseTask task_;
+
+  auto feed(const char* token) -> void {
+    auto& promise = task_.handle().promise();
+    while (promise.hasEvent) {
+      resume();
+    }
+    if (finished()) {
+      detail::raise<std::logic_error>("Incremental parse already finished");
+    }
+    promise.token = token;
+    resume();
+  }
+
+  auto resume() -> void {
+    auto& promise = task_.handle().promise();
+    promise.hasEvent = false;
+    task_.handle().resume();
+#if ETCHED_EXCEPTIONS
+    if (promise.error) {
+      std::rethrow_exception(std::exchange(promise.error, nullptr));
+    }
+#endif
+  }
+};
+
+}  // namespace etched
+
+#endif  // ETCHED_INCREMENTAL_HPP
@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "composite.hpp"
+#include "errors.hpp"
+#include "lookup.hpp"
+
+#ifndef ETCHED_KEYVALUES_HPP
+#define ETCHED_KEYVALUES_HPP
+
+namespace etched {
+
+// Repeatable key=value settings, as in --set a=1 --set b=2 or -Da=1. Entries
+// view the argument strings, so no text is copied, and are stored in place
+// with an open-addressed index over the keys. A repeated key keeps its first
+// position but takes the latest value. The entries live inside the option
+// and its default, so the default capacity is small; more distinct keys are
+// an out_of_range error.
+template <std::size_t Capacity = 16>
+  requires(Capacity > 0 && Capacity < UINT16_MAX / 2)
+class KeyValueMap {
+ public:
+  using Entry = std::pair<std::string_view, std::string_view>;
+  static constexpr std::size_t capacity = Capacity;
+
+  constexpr KeyValueMap() = default;
+
+  // Adds "key=value"; the text must outlive the map
+  constexpr auto insert(const char* setting) -> void {
+    const std::string_view text(setting);
+    const std::size_t eq = text.find('=');
+    if (eq == std::string_view::npos) {
+      detail::raise<std::invalid_argument>("Expected key=value");
+    }
+    if (eq == 0) {
+      detail::raise<std::invalid_argument>("Empty key in key=value");
+    }
+    insert(text.substr(0, eq), text.substr(eq + 1));
+  }
+
+  constexpr auto insert(std::string_view key, std::string_view value) -> void {
+    std::size_t slot = detail::nameHash(key, 0) & (slotCount - 1);
+    while (slots_[slot] != 0) {
+      Entry& entry = entries_[slots_[slot] - 1];
+      if (entry.first == key) {
+        entry.second = value;
+        return;
+      }
+      slot = (slot + 1) & (slotCount - 1);
+    }
+    if (size_ == Capacity) {
+      detail::raise<std::out_of_range>("Too many key=value settings");
+    }
+    entries_[size_] = {key, value};
+    slots_[slot] = static_cast<uint16_t>(++size_);
+  }
+
+  [[nodiscard]] constexpr auto find(std::string_view key) const
+      -> std::optional<std::string_view> {
+    std::size_t slot = detail::nameHash(key, 0) & (slotCount - 1);
+    while (slots_[slot] != 0) {
+      const Entry& entry = entries_[slots_[slot] - 1];
+      if (entry.first == key) {
+        return entry.second;
+      }
+      slot = (slot + 1) & (slotCount - 1);
+    }
+    return std::nullopt;
+  }
+
+  [[nodiscard]] constexpr auto contains(std::string_view key) const -> bool {
+    return find(key).has_value();
+  }
+
+  // Converts the value on access through fromView<T>, which respects its
+  // length: values inserted by key and value need not be NUL-terminated
+  template <typename T>
+  [[nodiscard]] auto get(std::string_view key) const -> std::optional<T> {
+    const auto value = find(key);
+    if (!value) {
+      return std::nullopt;
+    }
+    return fromView<T>(*value);
+  }
+
+  template <typename T>
+  [[nodiscard]] auto getOr(std::string_view key, T fallback) const -> T {
+    auto value = get<T>(key);
+    return value ? std::move(*value) : std::move(fallback);
+  }
+
+  [[nodiscard]] constexpr auto size() const -> std::size_t { return size_; }
+
+  [[nodiscard]] constexpr auto empty() const -> bool { return size_ == 0; }
+
+  // Entries in order of first occurrence
+  [[nodiscard]] constexpr auto begin() const -> const Entry* {
+    return entries_.data();
+  }
+
+  [[nodiscard]] constexpr auto end() const -> const Entry* {
+    return entries_.data() + size_;
+  }
+
+  static constexpr auto accumulate(std::optional<KeyValueMap>& current,
+                                   const char* str) -> void {
+    if (!str) {
+      detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+    }
+    if (!current) {
+      current.emplace();
+    }
+    current->insert(str);
+  }
+
+  static auto printValueHint(std::ostream& os) -> void { os << "key=value"; }
+
+ private:
+  static constexpr std::size_t slotCount = std::bit_ceil(Capacity) * 2;
+
+  std::array<Entry, Capacity> entries_{};
+  std::array<uint16_t, slotCount> slots_{};
+  std::size_t size_ = 0;
+};
+
+namespace detail {
+
+template <typename T>
+struct IsKeyValueMap : std::false_type {};
+
+template <std::size_t Capacity>
+struct IsKeyValueMap<KeyValueMap<Capacity>> : std::true_type {};
+
+template <typename T>
+concept KeyValueMapValue = IsKeyValueMap<T>::value;
+
+}  // namespace detail
+
+template <detail::KeyValueMapValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  T map;
+  map.insert(str);
+  return map;
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_KEYVALUES_HPP
@@ -0,0 +1,234 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "composite.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_LISTS_HPP
+#define ETCHED_LISTS_HPP
+
+namespace etched {
+
+namespace detail {
+
+// Values at least this long are converted across threads by default
+constexpr std::size_t defaultParallelListBytes = std::size_t{1} << 20;
+
+// Smallest slice of a value handed to one thread
+constexpr std::size_t minListChunkBytes = std::size_t{256} << 10;
+
+// Counts occurrences of `c` eight bytes at a time. Each matching byte of a
+// word becomes exactly one set high bit, so a popcount per word suffices.
+inline auto countByte(std::string_view str, char c) -> std::size_t {
+  constexpr uint64_t ones = 0x0101010101010101ULL;
+  constexpr uint64_t low7 = 0x7F7F7F7F7F7F7F7FULL;
+  const uint64_t pattern = ones * static_cast<unsigned char>(c);
+  std::size_t count = 0;
+  std::size_t pos = 0;
+  for (; pos + sizeof(uint64_t) <= str.size(); pos += sizeof(uint64_t)) {
+    uint64_t word = 0;
+    std::memcpy(&word, str.data() + pos, sizeof(word));
+    const uint64_t diff = word ^ pattern;
+    const uint64_t zero = ~(((diff & low7) + low7) | diff | low7);
+    count += static_cast<std::size_t>(std::popcount(zero));
+  }
+  for (; pos < str.size(); ++pos) {
+    count += static_cast<std::size_t>(str[pos] == c);
+  }
+  return count;
+}
+
+// Converts every field of `str` into out[0..], which has one slot per field
+template <typename T, char Delim>
+auto parseListInto(std::string_view str, T* out) -> void {
+  for (std::string_view field : Tokenizer<Delim>(str)) {
+    *out++ = fromView<T>(field);
+  }
+}
+
+// Splits `str` at delimiters into at most `chunks` slices of similar length,
+// converts them on separate threads and rethrows the first failure
+template <typename T, char Delim>
+auto parseListParallel(std::string_view str, std::size_t chunks,
+                       std::vector<T>& out) -> void {
+  std::vector<std::string_view> slices;
+  std::vector<std::size_t> offsets;
+  slices.reserve(chunks);
+  offsets.reserve(chunks);
+  std::size_t total = out.size();
+  std::size_t start = 0;
+  for (std::size_t k = 1; k <= chunks && start <= str.size(); ++k) {
+    std::size_t end = str.size();
+    if (k < chunks) {
+      end = str.find(Delim, std::max(start, str.size() / chunks * k));
+      end = end == std::string_view::npos ? str.size() : end;
+    }
+    const std::string_view slice = str.substr(start, end - start);
+    slices.push_back(slice);
+    offsets.push_back(total);
+    total += countByte(slice, Delim) + 1;
+    start = end + 1;
+  }
+  out.resize(total);
+#if ETCHED_EXCEPTIONS
+  std::vector<std::exception_ptr> errors(slices.size());
+  {
+    std::vector<std::jthread> workers;
+    workers.reserve(slices.size() - 1);
+    for (std::size_t k = 1; k < slices.size(); ++k) {
+      workers.emplace_back([&, k] {
+        try {
+          parseListInto<T, Delim>(slices[k], out.data() + offsets[k]);
+        } catch (...) {
+          errors[k] = std::current_exception();
+        }
+      });
+    }
+    try {
+      parseListInto<T, Delim>(slices[0], out.data() + offsets[0]);
+    } catch (...) {
+      errors[0] = std::current_exception();
+    }
+  }
+  for (const auto& error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+#else
+  // A failure goes to the error handler on whichever thread hits it
+  std::vector<std::jthread> workers;
+  workers.reserve(slices.size() - 1);
+  for (std::size_t k = 1; k < slices.size(); ++k) {
+    workers.emplace_back([&, k] {
+      parseListInto<T, Delim>(slices[k], out.data() + offsets[k]);
+    });
+  }
+  parseListInto<T, Delim>(slices[0], out.data() + offsets[0]);
+#endif
+}
+
+}  // namespace detail
+
+// Delimited list of values such as --ids=1,2,3, stored contiguously. The
+// field count is taken first with a word-at-a-time delimiter scan so the
+// storage is allocated once; fields then convert in place through fromView.
+// Values of at least ParallelBytes are split at delimiters and converted on
+// several threads. Repeated occurrences append.
+template <typename T, char Delim = ',',
+          std::size_t ParallelBytes = detail::defaultParallelListBytes>
+class List {
+ public:
+  using UnderlyingType = std::vector<T>;
+  static constexpr char delimiter = Delim;
+
+  constexpr List() = default;
+
+  constexpr List(std::vector<T> values) : values_(std::move(values)) {}  // NOLINT
+
+  constexpr operator const std::vector<T>&() const { return values_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> const std::vector<T>& {
+    return values_;
+  }
+
+  [[nodiscard]] constexpr auto span() const -> std::span<const T> {
+    return values_;
+  }
+
+  [[nodiscard]] constexpr auto size() const -> std::size_t {
+    return values_.size();
+  }
+
+  [[nodiscard]] constexpr auto begin() const { return values_.begin(); }
+
+  [[nodiscard]] constexpr auto end() const { return values_.end(); }
+
+  constexpr auto operator[](std::size_t idx) const -> const T& {
+    return values_[idx];
+  }
+
+  // Appends the fields of `str`
+  auto append(std::string_view str) -> void {
+    const std::size_t threads = threadsFor(str.size());
+    if constexpr (std::default_initializable<T>) {
+      if (threads > 1) {
+        detail::parseListParallel<T, Delim>(str, threads, values_);
+        return;
+      }
+    }
+    values_.reserve(values_.size() + detail::countByte(str, Delim) + 1);
+    for (std::string_view field : Tokenizer<Delim>(str)) {
+      values_.push_back(fromView<T>(field));
+    }
+  }
+
+  static auto accumulate(std::optional<List>& current, const char* str)
+      -> void {
+    if (!str) {
+      detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+    }
+    if (!current) {
+      current.emplace();
+    }
+    current->append(str);
+  }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    os << "x" << Delim << "y" << Delim << "...";
+  }
+
+ private:
+  std::vector<T> values_;
+
+  static auto threadsFor(std::size_t bytes) -> std::size_t {
+    if (bytes < ParallelBytes) {
+      return 1;
+    }
+    const std::size_t hardware = std::thread::hardware_concurrency();
+    return std::clamp<std::size_t>(bytes / detail::minListChunkBytes, 1,
+                                   std::max<std::size_t>(hardware, 1));
+  }
+};
+
+namespace detail {
+
+template <typename T>
+struct IsList : std::false_type {};
+
+template <typename T, char Delim, std::size_t ParallelBytes>
+struct IsList<List<T, Delim, ParallelBytes>> : std::true_type {};
+
+template <typename T>
+concept ListValue = IsList<T>::value;
+
+}  // namespace detail
+
+template <detail::ListValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  T list;
+  list.append(str);
+  return list;
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_LISTS_HPP
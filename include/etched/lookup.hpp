@@ -0,0 +1,195 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "concepts.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_LOOKUP_HPP
+#define ETCHED_LOOKUP_HPP
+
+namespace etched::detail {
+
+// Name lookup tables for a fixed option set. ArgumentParser builds one inside
+// its consteval constructor, so resolving a short option is a single array
+// index and resolving a long option only compares names of the same length.
+template <std::size_t K>
+struct OptionIndex {
+  static constexpr std::size_t npos = K;
+  static constexpr std::size_t asciiSize = 128;
+
+  std::array<std::uint8_t, asciiSize> shortIdx{};
+  std::array<std::string_view, K> longNames{};
+  // Option indices ordered by long name, for prefix queries
+  std::array<std::uint8_t, K> longOrder{};
+
+  template <IsOption... Options>
+    requires(sizeof...(Options) == K)
+  static constexpr auto build(const Options&... opts) -> OptionIndex {
+    OptionIndex index{};
+    index.shortIdx.fill(static_cast<std::uint8_t>(npos));
+    std::size_t current = 0;
+    ((index.add(current++, opts)), ...);
+    for (std::size_t i = 0; i < K; ++i) {
+      index.longOrder[i] = static_cast<std::uint8_t>(i);
+    }
+    std::sort(index.longOrder.begin(), index.longOrder.end(),
+              [&index](std::uint8_t a, std::uint8_t b) {
+                return index.longNames[a] < index.longNames[b];
+              });
+    return index;
+  }
+
+  // Range of longOrder whose names start with `prefix`; options without a
+  // long name sort first and never match a non-empty prefix
+  [[nodiscard]] constexpr auto findPrefix(std::string_view prefix) const
+      -> std::pair<std::size_t, std::size_t> {
+    const auto byName = [this](std::uint8_t idx, std::string_view name) {
+      return longNames[idx].substr(0, name.size()) < name;
+    };
+    auto first = std::lower_bound(longOrder.begin(), longOrder.end(), prefix,
+                                  byName);
+    while (first != longOrder.end() && longNames[*first].empty()) {
+      ++first;
+    }
+    auto last = first;
+    while (last != longOrder.end() && longNames[*last].starts_with(prefix)) {
+      ++last;
+    }
+    return {static_cast<std::size_t>(first - longOrder.begin()),
+            static_cast<std::size_t>(last - longOrder.begin())};
+  }
+
+  [[nodiscard]] constexpr auto findShort(char c) const -> std::size_t {
+    const auto code = static_cast<unsigned char>(c);
+    return code < asciiSize ? shortIdx[code] : npos;
+  }
+
+  [[nodiscard]] constexpr auto findLong(std::string_view name) const
+      -> std::size_t {
+    std::size_t comparisons = 0;
+    return findLong(name, comparisons);
+  }
+
+  // Also counts the names compared, for instrumentation
+  [[nodiscard]] constexpr auto findLong(std::string_view name,
+                                        std::size_t& comparisons) const
+      -> std::size_t {
+    if (name.empty()) {
+      return npos;
+    }
+    for (std::size_t i = 0; i < K; ++i) {
+      if (longNames[i].size() == name.size()) {
+        ++comparisons;
+        if (longNames[i] == name) {
+          return i;
+        }
+      }
+    }
+    return npos;
+  }
+
+ private:
+  template <IsOption Opt>
+  constexpr auto add(std::size_t idx, const Opt& opt) -> void {
+    if (opt.shortName) {
+      const char* shortName = opt.shortName.value();
+      if (shortName[0] == '-' && shortName[1] != '-' && shortName[1] != '\0') {
+        const auto code = static_cast<unsigned char>(shortName[1]);
+        if (shortName[2] != '\0' || code >= asciiSize) {
+          detail::raise<std::invalid_argument>(
+              "Short flag must be a single ASCII character");
+        }
+        shortIdx[code] = static_cast<std::uint8_t>(idx);
+      }
+    }
+    if (opt.longName) {
+      const char* longName = opt.longName.value();
+      if (longName[0] == '-' && longName[1] == '-' && longName[2] != '\0') {
+        longNames[idx] = std::string_view(longName + 2);
+      }
+    }
+  }
+};
+
+constexpr auto nameHash(std::string_view name, uint32_t seed) -> uint32_t {
+  constexpr uint32_t prime = 16777619U;
+  uint32_t hash = seed ^ static_cast<uint32_t>(name.size());
+  for (const char c : name) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+  }
+  return hash;
+}
+
+// Open-addressed table over a fixed name list, used for enum and feature
+// names. The hash seed is searched at compile time for the shortest probe
+// sequence, usually one slot: a lookup is then one hash and one comparison.
+template <std::size_t K>
+struct HashedNameTable {
+  static constexpr std::size_t size = std::bit_ceil(K) * 4;
+  static constexpr std::size_t npos = K;
+  static constexpr uint32_t seedCount = 256;
+
+  std::array<uint8_t, size> slots{};
+  uint32_t seed = 0;
+  std::size_t maxProbe = 0;
+
+  static consteval auto build(const std::array<std::string_view, K>& names)
+      -> HashedNameTable {
+    for (std::size_t i = 0; i < K; ++i) {
+      for (std::size_t j = i + 1; j < K; ++j) {
+        if (names[i] == names[j]) {
+          detail::raise<std::invalid_argument>("Duplicate name");
+        }
+      }
+    }
+    HashedNameTable best{};
+    best.maxProbe = SIZE_MAX;
+    for (uint32_t seed = 0; seed < seedCount && best.maxProbe > 1; ++seed) {
+      HashedNameTable table{};
+      table.seed = seed;
+      table.slots.fill(static_cast<uint8_t>(npos));
+      for (std::size_t i = 0; i < K; ++i) {
+        std::size_t slot = nameHash(names[i], seed) & (size - 1);
+        std::size_t probe = 1;
+        while (table.slots[slot] != npos) {
+          slot = (slot + 1) & (size - 1);
+          ++probe;
+        }
+        table.slots[slot] = static_cast<uint8_t>(i);
+        table.maxProbe = std::max(table.maxProbe, probe);
+      }
+      if (table.maxProbe < best.maxProbe) {
+        best = table;
+      }
+    }
+    return best;
+  }
+
+  [[nodiscard]] constexpr auto find(
+      const std::array<std::string_view, K>& names, std::string_view name) const
+      -> std::size_t {
+    std::size_t slot = nameHash(name, seed) & (size - 1);
+    for (std::size_t probe = 0; probe < maxProbe; ++probe) {
+      const std::size_t idx = slots[slot];
+      if (idx == npos) {
+        return npos;
+      }
+      if (names[idx] == name) {
+        return idx;
+      }
+      slot = (slot + 1) & (size - 1);
+    }
+    return npos;
+  }
+};
+
+}  // namespace etched::detail
+
+#endif  // ETCHED_LOOKUP_HPP
@@ -1,5 +1,7 @@
 #pragma once
 #include <optional>
+#include <type_traits>
+
 #include "concepts.hpp"
 #include "strings.hpp"
 
@@ -20,8 +22,11 @@ struct Option {
   static constexpr auto tag = OptTag;
 };
 
+// Option whose callback runs after the whole command line has parsed. A
+// bool option calls callback(); any other type calls callback(value).
 template <typename T, String OptTag, typename CallbackType>
-  requires HasFromStr<T> && ISCallback<CallbackType>
+  requires HasFromStr<T> && (ISCallback<CallbackType> ||
+                             std::is_invocable_v<CallbackType, const T&>)
 struct OptionWithCallback {
   using CallbackT = CallbackType;
   CallbackType callback;
@@ -30,10 +35,20 @@ struct OptionWithCallback {
   std::optional<const char*> longName = std::nullopt;
   std::optional<const char*> description = std::nullopt;
   std::optional<T> defaultValue = std::nullopt;
+  // Callbacks run in ascending priority, then declaration order
+  int priority = 0;
+  // Set when the option occurs, cleared once the callback has run
+  bool triggered = false;
   using ValueType = T;
   static constexpr auto tag = OptTag;
 
-  void triggerCallback() { callback(); }
+  void triggerCallback() {
+    if constexpr (std::is_invocable_v<CallbackType, const T&>) {
+      callback(value.value());
+    } else {
+      callback();
+    }
+  }
 };
 }  // namespace etched::detail
 
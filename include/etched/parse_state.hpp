@@ -0,0 +1,122 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#include "trace.hpp"
+
+#ifndef ETCHED_PARSE_STATE_HPP
+#define ETCHED_PARSE_STATE_HPP
+
+namespace etched {
+
+namespace detail {
+
+// One bit per option of a parser, by declaration index
+template <std::size_t K>
+struct OptionMask {
+  static constexpr std::size_t wordBits = 64;
+  static constexpr std::size_t words = (K + wordBits - 1) / wordBits;
+
+  std::array<uint64_t, words> bits{};
+
+  constexpr auto set(std::size_t idx) -> void {
+    bits[idx / wordBits] |= uint64_t{1} << (idx % wordBits);
+  }
+
+  [[nodiscard]] constexpr auto test(std::size_t idx) const -> bool {
+    return ((bits[idx / wordBits] >> (idx % wordBits)) & 1U) != 0;
+  }
+
+  [[nodiscard]] constexpr auto none() const -> bool {
+    for (const uint64_t word : bits) {
+      if (word != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Lowest index set, or K
+  [[nodiscard]] constexpr auto first() const -> std::size_t {
+    for (std::size_t w = 0; w < words; ++w) {
+      if (bits[w] != 0) {
+        return w * wordBits + static_cast<std::size_t>(std::countr_zero(bits[w]));
+      }
+    }
+    return K;
+  }
+
+  constexpr auto operator|=(const OptionMask& other) -> OptionMask& {
+    for (std::size_t w = 0; w < words; ++w) {
+      bits[w] |= other.bits[w];
+    }
+    return *this;
+  }
+
+  constexpr auto operator&(const OptionMask& other) const -> OptionMask {
+    OptionMask result = *this;
+    for (std::size_t w = 0; w < words; ++w) {
+      result.bits[w] &= other.bits[w];
+    }
+    return result;
+  }
+
+  // Bits of `other` missing here
+  [[nodiscard]] constexpr auto missing(const OptionMask& other) const
+      -> OptionMask {
+    OptionMask result = other;
+    for (std::size_t w = 0; w < words; ++w) {
+      result.bits[w] &= ~bits[w];
+    }
+    return result;
+  }
+
+  constexpr auto operator==(const OptionMask& other) const -> bool = default;
+};
+
+// Redirects option values when the tokens they come from do not outlive the
+// parse, e.g. a stream reusing its read buffer
+struct ValueHooks {
+  void* context = nullptr;
+  // Copies the value of a single-valued option to lasting storage
+  const char* (*retain)(void* context, std::size_t option,
+                        const char* text) = nullptr;
+  // Copies a value of an accumulating option to storage kept for the whole
+  // parse, as earlier values may still be viewed
+  const char* (*keep)(void* context, std::size_t option,
+                      const char* text) = nullptr;
+  // If set, told of each value of an accumulating option once kept
+  void (*repeat)(void* context, std::size_t option, const char* text) = nullptr;
+  // If set, told of each option occurrence once applied, with the value
+  // text it took or null for flags
+  void (*applied)(void* context, std::size_t option,
+                  const char* text) = nullptr;
+};
+
+// What a strategy records for the parser while parsing
+template <std::size_t K, TracePolicy Trace = NoTrace>
+struct ParseState {
+  // Options that occurred on the command line
+  OptionMask<K> seen;
+  // Value text per option under a lazy strategy, or null to convert eagerly
+  const char** pending = nullptr;
+  // Arguments for another program under a pass-through strategy, in order,
+  // or null to reject them. Holds at least as many pointers as argv.
+  const char** passThrough = nullptr;
+  std::size_t passThroughCount = 0;
+  // Set when tokens arrive one at a time: an option whose value is the next
+  // token records its index in `awaiting` instead of failing
+  bool incremental = false;
+  std::size_t awaiting = K;
+  const ValueHooks* hooks = nullptr;
+  // Empty unless the parser's instrumentation policy is enabled
+  [[no_unique_address]] TraceStateFor<Trace> trace{};
+};
+
+}  // namespace detail
+
+}  // namespace etched
+
+#endif  // ETCHED_PARSE_STATE_HPP
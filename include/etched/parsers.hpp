@@ -1,14 +1,33 @@
 #pragma once
 #include <array>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <string_view>
 #include <type_traits>
 
+#include "bounded.hpp"
+#include "composite.hpp"
 #include "concepts.hpp"
+#include "constraints.hpp"
 #include "converters.hpp"
+#include "counts.hpp"
+#include "enums.hpp"
+#include "errors.hpp"
+#include "features.hpp"
+#include "files.hpp"
+#include "keyvalues.hpp"
+#include "lists.hpp"
+#include "parse_state.hpp"
+#include "lookup.hpp"
+#include "suggestions.hpp"
+#include "trace.hpp"
+#include "units.hpp"
 
 #ifndef ETCHED_PARSERS_HPP
 #define ETCHED_PARSERS_HPP
@@ -16,95 +35,311 @@
 namespace etched::detail {
 
 struct DefaultParserStrategy {
+  // How much input an option consumed besides its own flag; UNKNOWN marks
+  // an argument left for pass-through, DEFERRED a value that will be the
+  // next token of an incremental parse
+  enum class Consumed : std::uint8_t {
+    NONE,
+    ATTACHED,
+    NEXT,
+    UNKNOWN,
+    DEFERRED
+  };
+
+  // What parseToken() made of a token
+  enum class Token : std::uint8_t { OPTION, POSITIONAL, SEPARATOR };
+
   template <std::size_t N, IsOption... Options>
   static auto parse(const int argc, std::array<const char*, N> argv,  // NOLINT
                     Options&... opts) -> void {
+    const auto index = OptionIndex<sizeof...(Options)>::build(opts...);
+    parse(argc, argv, index, opts...);
+  }
+
+  template <std::size_t N, std::size_t K, IsOption... Options>
+    requires(K == sizeof...(Options))
+  static auto parse(const int argc, std::array<const char*, N> argv,  // NOLINT
+                    const OptionIndex<K>& index, Options&... opts) -> void {
+    ParseState<K> state;
+    parse(argc, argv, index, state, opts...);
+  }
+
+  // Records which options occurred in `state`. With state.pending set,
+  // values are left unconverted there for the parser to convert on access;
+  // flags, counts and accumulating values, which depend on every
+  // occurrence, still apply immediately.
+  template <std::size_t N, std::size_t K, TracePolicy Trace,
+            IsOption... Options>
+    requires(K == sizeof...(Options))
+  static auto parse(const int argc, std::array<const char*, N> argv,  // NOLINT
+                    const OptionIndex<K>& index, ParseState<K, Trace>& state,
+                    Options&... opts) -> void {
     for (int i = 1; i < argc; ++i) {
       const char* arg = argv[i];
-      if (arg[0] != '-') {
-        throw std::invalid_argument(
-            std::string("Unexpected positional argument: ") + arg);
+      if constexpr (Trace::enabled) {
+        state.trace.token = static_cast<std::uint16_t>(i);
+        state.trace.comparisons = 0;
       }
-      const char* tagName = arg;
-      if (arg[0] == '-' && arg[1] == '-') {
-        tagName = arg + 2;
-      } else if (arg[0] == '-') {
-        tagName = arg + 1;
+      const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+      if (state.passThrough != nullptr) {
+        if (std::strcmp(arg, "--") == 0) {
+          // Everything after "--" is forwarded as is, without the "--"
+          while (++i < argc) {
+            state.passThrough[state.passThroughCount++] = argv[i];
+          }
+          break;
+        }
+        if (arg[0] != '-' || arg[1] == '\0') {
+          state.passThrough[state.passThroughCount++] = arg;
+          continue;
+        }
+      } else if (arg[0] != '-' || arg[1] == '\0') {
+        detail::raise<std::invalid_argument>(
+            std::string("Unexpected positional argument: ") + arg);
       }
-
-      // Check if this is a terminal option (help/version)
-      bool isTerminal = ((isTerminalOption(opts, tagName)) || ...);
-      if (isTerminal && i + 1 < argc) {
-        throw std::invalid_argument(
-            std::string("No arguments allowed after terminal option: ") + arg);
+      const Consumed consumed =
+          arg[1] == '-' ? parseLong(arg, next, index, state, opts...)
+                        : parseShortCluster(arg, next, index, state, opts...);
+      if (consumed == Consumed::NEXT) {
+        ++i;
+      } else if (consumed == Consumed::UNKNOWN) {
+        state.passThrough[state.passThroughCount++] = arg;
       }
+    }
+  }
 
-      // Check for help (terminates program immediately)
-      ((matchAndSetHelp(opts, tagName, opts...)), ...);
+  // Parses one token of an incremental parse, where the tokens after it are
+  // not known yet. An option taking its value from the next token leaves its
+  // index in state.awaiting and consumes the token fed after it. Positional
+  // arguments and "--" are left to the caller.
+  template <std::size_t K, TracePolicy Trace, IsOption... Options>
+  static auto parseToken(const char* arg, const OptionIndex<K>& index,
+                         ParseState<K, Trace>& state, Options&... opts)
+      -> Token {
+    if (state.awaiting != K) {
+      const std::size_t idx = state.awaiting;
+      state.awaiting = K;
+      applyOption(idx, arg, nullptr, arg, state, opts...);
+      return Token::OPTION;
+    }
+    if (arg[0] != '-' || arg[1] == '\0') {
+      return Token::POSITIONAL;
+    }
+    if (arg[1] == '-' && arg[2] == '\0') {
+      return Token::SEPARATOR;
+    }
+    if (arg[1] == '-') {
+      parseLong(arg, nullptr, index, state, opts...);
+    } else {
+      parseShortCluster(arg, nullptr, index, state, opts...);
+    }
+    return Token::OPTION;
+  }
 
-      // Check for callbacks and boolean flags
-      bool matchedBool = ((matchAndSetBool(opts, tagName)) || ...);
-      bool matchedCallback = ((matchAndSetCallback(opts, tagName)) || ...);
-      if (matchedBool || matchedCallback) {
-        continue;
-      }
-      if (i + 1 >= argc) {
-        throw std::invalid_argument(std::string("Option requires a value: ") +
-                                    arg);
-      }
-      const char* value = argv[i + 1];
-      bool matched = ((matchAndSet(opts, tagName, value)) || ...);
-      if (matched) {
-        ++i;  // Consume the value argument
-      } else {
-        throw std::invalid_argument(
-            std::string("Unknown option or missing value for option: ") + arg);
+  // --name, --name value or --name=value
+  template <std::size_t K, TracePolicy Trace, IsOption... Options>
+  static auto parseLong(const char* arg, const char* next,  // NOLINT
+                        const OptionIndex<K>& index,
+                        ParseState<K, Trace>& state, Options&... opts)
+      -> Consumed {
+    const char* name = arg + 2;
+    const char* eq = std::strchr(name, '=');
+    const std::string_view key =
+        eq != nullptr ? std::string_view(name, eq - name) : name;
+    const char* attached = eq != nullptr ? eq + 1 : nullptr;
+    std::size_t comparisons = 0;
+    const std::size_t idx = index.findLong(key, comparisons);
+    if constexpr (Trace::enabled) {
+      state.trace.comparisons = static_cast<std::uint16_t>(comparisons);
+    }
+    if (idx == OptionIndex<K>::npos) {
+      if (state.passThrough != nullptr) {
+        return Consumed::UNKNOWN;
       }
+      record(state, idx, TraceStatus::UNKNOWN_OPTION, 0);
+      std::string message = std::string("Unknown option: ") + arg;
+      appendSuggestions(message, key, index);
+      detail::raise<std::invalid_argument>(message);
+    }
+    const Consumed consumed =
+        applyOption(idx, arg, attached, next, state, opts...);
+    if (attached != nullptr && consumed == Consumed::NONE) {
+      detail::raise<std::invalid_argument>(
+          std::string("Option does not take a value: ") + arg);
     }
+    return consumed;
   }
 
-  template <IsOption Opt>
-  static auto isTerminalOption(const Opt& opt, const char* name)  // NOLINT
-      -> bool {
-    if constexpr (Opt::tag == "help" || Opt::tag == "version") {
-      return matchesName(opt, name);
+  // -x, -x value, -xvalue and bundled flags such as -abc or -abj8
+  template <std::size_t K, TracePolicy Trace, IsOption... Options>
+  static auto parseShortCluster(const char* arg, const char* next,  // NOLINT
+                                const OptionIndex<K>& index,
+                                ParseState<K, Trace>& state, Options&... opts)
+      -> Consumed {
+    for (const char* flag = arg + 1; *flag != '\0'; ++flag) {
+      const std::size_t idx = index.findShort(*flag);
+      if (idx == OptionIndex<K>::npos) {
+        // Only a cluster that starts with an unknown flag is forwarded;
+        // one that mixes known and unknown flags cannot be split
+        if (state.passThrough != nullptr && flag == arg + 1) {
+          return Consumed::UNKNOWN;
+        }
+        record(state, idx, TraceStatus::UNKNOWN_OPTION, 0);
+        std::string message = std::string("Unknown option: -") + *flag;
+        if (flag != arg + 1) {
+          message += std::string(" in ") + arg;
+        }
+        // A failing cluster is often a long option typed with a single dash
+        if (arg[2] != '\0') {
+          appendSuggestions(message, arg + 1, index);
+        }
+        detail::raise<std::invalid_argument>(message);
+      }
+      const char* attached = flag[1] != '\0' ? flag + 1 : nullptr;
+      const Consumed consumed =
+          applyOption(idx, arg, attached, next, state, opts...);
+      if (consumed != Consumed::NONE) {
+        return consumed;
+      }
     }
-    return false;
+    return Consumed::NONE;
   }
 
-  template <IsOption Opt, IsOption... Options>
-  static auto matchAndSetHelp(Opt& opt, const char* name,  // NOLINT
-                              Options&... opts)             // NOLINT
-      -> void {
-    if constexpr (Opt::tag == "help") {
-      if (matchesName(opt, name)) {
+  // Applies the option at idx. `attached` is text glued to the flag (the rest
+  // of a short cluster or what follows '='), `next` the following argument.
+  template <TracePolicy Trace, IsOption... Options>
+  static auto applyOption(std::size_t idx, const char* arg,  // NOLINT
+                          const char* attached, const char* next,
+                          ParseState<sizeof...(Options), Trace>& state,
+                          Options&... opts) -> Consumed {
+    state.seen.set(idx);
+    const char** pending = state.pending;
+    Consumed consumed = Consumed::NONE;
+    std::size_t current = 0;
+    [[maybe_unused]] std::uint64_t nanos = 0;
+    const char* value = nullptr;
+    auto store = [&](auto& opt, const char* text) -> void {
+      using ValueType = typename std::remove_cvref_t<decltype(opt)>::ValueType;
+      if (state.hooks != nullptr) {
+        if constexpr (AccumulatingValue<ValueType>) {
+          text = state.hooks->keep(state.hooks->context, idx, text);
+          if (state.hooks->repeat != nullptr) {
+            state.hooks->repeat(state.hooks->context, idx, text);
+          }
+        } else {
+          text = state.hooks->retain(state.hooks->context, idx, text);
+        }
+      }
+      value = text;
+      if constexpr (Trace::enabled) {
+        const auto start = std::chrono::steady_clock::now();
+        storeValue(opt, text, pending, idx);
+        nanos = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count());
+      } else {
+        storeValue(opt, text, pending, idx);
+      }
+    };
+    auto apply = [&](auto& opt) -> void {
+      using Opt = std::remove_cvref_t<decltype(opt)>;
+      if constexpr (Opt::tag == "help" || Opt::tag == "version") {
+        if (attached != nullptr || next != nullptr) {
+          detail::raise<std::invalid_argument>(
+              std::string("No arguments allowed after terminal option: ") +
+              arg);
+        }
+      }
+      if constexpr (IsCallbackOption<Opt>) {
+        // Run by the parser once the whole command line has been accepted
+        opt.triggered = true;
+      }
+      if constexpr (Opt::tag == "help") {
         printHelp(opts...);
         std::exit(0);
+      } else if constexpr (std::is_same_v<typename Opt::ValueType, bool>) {
+        opt.value = true;
+      } else if constexpr (CountingValue<typename Opt::ValueType>) {
+        Opt::ValueType::increment(opt.value);
+      } else if (attached != nullptr) {
+        store(opt, attached);
+        consumed = Consumed::ATTACHED;
+      } else if (next != nullptr) {
+        store(opt, next);
+        consumed = Consumed::NEXT;
+      } else if (state.incremental) {
+        state.awaiting = idx;
+        consumed = Consumed::DEFERRED;
+      } else {
+        detail::raise<std::invalid_argument>(
+            std::string("Option requires a value: ") + arg);
+      }
+    };
+    auto dispatch = [&]() -> void {
+      static_cast<void>(
+          ((current++ == idx ? (apply(opts), true) : false) || ...));
+    };
+    if constexpr (Trace::enabled) {
+#if ETCHED_EXCEPTIONS
+      try {
+        dispatch();
+      } catch (...) {
+        record(state, idx, TraceStatus::FAILED, nanos);
+        throw;
+      }
+#else
+      // Failures never return here without exceptions
+      dispatch();
+#endif
+      // A deferred value is recorded once it arrives
+      if (consumed != Consumed::DEFERRED) {
+        record(state, idx, TraceStatus::OK, nanos);
       }
+    } else {
+      dispatch();
+    }
+    if (state.hooks != nullptr && state.hooks->applied != nullptr &&
+        consumed != Consumed::DEFERRED) {
+      state.hooks->applied(state.hooks->context, idx, value);
+    }
+    return consumed;
+  }
+
+  // Sends an event for the current token when instrumentation is enabled
+  template <std::size_t K, TracePolicy Trace>
+  static auto record(ParseState<K, Trace>& state, std::size_t option,
+                     TraceStatus status, std::uint64_t nanos) -> void {
+    if constexpr (Trace::enabled) {
+      state.trace.sink->record(TraceEvent{
+          .token = state.trace.token,
+          .option = static_cast<std::uint16_t>(option),
+          .comparisons = state.trace.comparisons,
+          .status = status,
+          .convertNanos = nanos});
     }
   }
 
   template <IsOption Opt>
-  static auto matchAndSetCallback(Opt& opt, const char* name)  // NOLINT
-      -> bool {
-    if constexpr (IsCallbackOption<Opt>) {
-      if (matchesName(opt, name)) {
-        opt.triggerCallback();
-        return true;
+  static auto storeValue(Opt& opt, const char* text, const char** pending,
+                         std::size_t idx) -> void {
+    if constexpr (!AccumulatingValue<typename Opt::ValueType>) {
+      if (pending != nullptr) {
+        pending[idx] = text;  // NOLINT
+        return;
       }
     }
-    return false;
+    assignValue(opt, text);
   }
 
   template <IsOption Opt>
-  static auto matchAndSetBool(Opt& opt, const char* name) -> bool {  // NOLINT
-    if constexpr (std::is_same_v<typename Opt::ValueType, bool>) {
-      if (matchesName(opt, name)) {
-        opt.value = true;
-        return true;
-      }
+  static auto assignValue(Opt& opt, const char* text) -> void {
+    using ValueType = typename Opt::ValueType;
+    if constexpr (AccumulatingValue<ValueType>) {
+      ValueType::accumulate(opt.value, text);
+    } else {
+      opt.value = fromStr<ValueType>(text);
     }
-    return false;
   }
 
   template <IsOption Opt>
@@ -124,9 +359,14 @@ struct DefaultParserStrategy {
         std::cout << longName;
       }
     }
-    if constexpr (!std::is_same_v<typename Opt::ValueType, bool>) {
+    if constexpr (!std::is_same_v<typename Opt::ValueType, bool> &&
+                  !CountingValue<typename Opt::ValueType>) {
       std::cout << " <value>";
     }
+    if constexpr (HasValueHint<typename Opt::ValueType>) {
+      std::cout << " ";
+      Opt::ValueType::printValueHint(std::cout);
+    }
     if (opt.description) {
       std::cout << "    " << opt.description.value();
     }
@@ -137,41 +377,32 @@ struct DefaultParserStrategy {
   static auto printHelp(Options&... opts) -> void {
     ((printHelpOption(opts)), ...);
   }
+};
 
-  template <IsOption Opt>
-  static auto matchAndSet(Opt& opt, const char* name,  // NOLINT
-                          const char* value)           // NOLINT
-      -> bool {
-    if constexpr (std::is_same_v<typename Opt::ValueType, bool>) {
-      return false;
-    }
-    if (matchesName(opt, name)) {
-      opt.value = fromStr<typename Opt::ValueType>(value);
-      return true;
-    }
-    return false;
-  }
+// Strategies that can parse one token at a time through parseToken()
+template <typename T>
+concept IncrementalStrategy = requires { typename T::Token; };
 
-  template <IsOption Opt>
-  static auto matchesName(const Opt& opt, const char* name) -> bool {
-    if (opt.shortName) {
-      const char* shortName = opt.shortName.value();
-      if (shortName[0] == '-' && shortName[1] != '-') {
-        if (strcmp(shortName + 1, name) == 0) {
-          return true;
-        }
-      }
-    }
-    if (opt.longName) {
-      const char* longName = opt.longName.value();
-      if (longName[0] == '-' && longName[1] == '-') {
-        if (strcmp(longName + 2, name) == 0) {
-          return true;
-        }
-      }
-    }
-    return false;
-  }
+// Leaves values as text during parsing; the parser converts each on its
+// first access and caches the result
+struct LazyParserStrategy : DefaultParserStrategy {
+  static constexpr bool lazy = true;
+};
+
+template <typename T>
+concept LazyStrategy = requires {
+  requires T::lazy;
+};
+
+// Collects unknown options, positional arguments and everything after "--"
+// for another program instead of rejecting them
+struct PassThroughParserStrategy : DefaultParserStrategy {
+  static constexpr bool passThrough = true;
+};
+
+template <typename T>
+concept PassThroughStrategy = requires {
+  requires T::passThrough;
 };
 
 }  // namespace etched::detail
@@ -0,0 +1,330 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/inotify.h>)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define ETCHED_HAS_INOTIFY 1
+#else
+#define ETCHED_HAS_INOTIFY 0
+#endif
+
+#include "errors.hpp"
+#include "strings.hpp"
+
+#ifndef ETCHED_RELOAD_HPP
+#define ETCHED_RELOAD_HPP
+
+namespace etched {
+
+// Option values that can be replaced while other threads read them. Each
+// reload parses into a fresh copy of the base parser and publishes it with
+// one atomic pointer swap. Readers pin the current epoch in a slot of their
+// own, so reading is wait-free; replaced versions are freed once no reader
+// pinned an epoch from before the swap. Reloads serialize on a mutex.
+//
+// Config files hold one argument per line, e.g. "--timeout=5s"; blank lines
+// and lines starting with '#' are skipped.
+template <typename Parser, std::size_t MaxReaders = 64>  // NOLINT
+  requires(MaxReaders > 0)
+class LiveOptions {
+  using ParserType = std::remove_cvref_t<Parser>;
+
+  struct Version {
+    std::string text;
+    std::vector<const char*> argv;
+    ParserType parser;
+    uint64_t retiredAt = 0;
+  };
+
+  struct alignas(64) Slot {  // NOLINT
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<bool> claimed{false};
+  };
+
+ public:
+  // Consistent view of one version, valid until destroyed
+  class View {
+   public:
+    View(const View&) = delete;
+    auto operator=(const View&) -> View& = delete;
+
+    ~View() { slot_->epoch.store(0, std::memory_order_release); }
+
+    auto operator->() const -> const ParserType* { return &version_->parser; }
+
+    auto operator*() const -> const ParserType& { return version_->parser; }
+
+    template <detail::String Tag>
+    [[nodiscard]] auto getOption() const -> const auto& {
+      return version_->parser.template getOption<Tag>();
+    }
+
+   private:
+    friend class LiveOptions;
+
+    View(Slot* slot, const Version* version) : slot_(slot), version_(version) {}
+
+    Slot* slot_;
+    const Version* version_;
+  };
+
+  // Per-thread handle owning one epoch slot
+  class Reader {
+   public:
+    Reader(const Reader&) = delete;
+    auto operator=(const Reader&) -> Reader& = delete;
+
+    Reader(Reader&& other) noexcept
+        : live_(other.live_), slot_(std::exchange(other.slot_, nullptr)) {}
+
+    auto operator=(Reader&&) -> Reader& = delete;
+
+    ~Reader() {
+      if (slot_ != nullptr) {
+        slot_->claimed.store(false, std::memory_order_release);
+      }
+    }
+
+    // Pins the current version; views must not nest on one reader
+    [[nodiscard]] auto read() const -> View {
+      slot_->epoch.store(live_->epoch_.load(std::memory_order_seq_cst),
+                         std::memory_order_seq_cst);
+      return View(slot_, live_->current_.load(std::memory_order_seq_cst));
+    }
+
+   private:
+    friend class LiveOptions;
+
+    Reader(const LiveOptions* live, Slot* slot) : live_(live), slot_(slot) {}
+
+    const LiveOptions* live_;
+    Slot* slot_;
+  };
+
+  // `base` supplies defaults and anything already parsed, such as argv
+  explicit LiveOptions(const ParserType& base)
+      : base_(base), current_(new Version{{}, {}, base}) {
+    current_.load()->parser.validateAll();
+  }
+
+  LiveOptions(const LiveOptions&) = delete;
+  auto operator=(const LiveOptions&) -> LiveOptions& = delete;
+
+  ~LiveOptions() {
+    delete current_.load();
+    for (Version* version : retired_) {
+      delete version;
+    }
+  }
+
+  [[nodiscard]] auto registerReader() const -> Reader {
+    for (auto& slot : slots_) {
+      bool expected = false;
+      if (slot.claimed.compare_exchange_strong(expected, true,
+                                               std::memory_order_acq_rel)) {
+        return Reader(this, &slot);
+      }
+    }
+    detail::raise<std::out_of_range>("Too many reader threads");
+  }
+
+  // Parses `text`, one argument per line, over the base values and
+  // publishes the result. On error the current version stays in place.
+  auto reload(std::string text) -> void {
+    auto version = std::make_unique<Version>(Version{std::move(text), {}, base_});
+    version->argv.push_back("config");
+    std::size_t start = 0;
+    std::string& buffer = version->text;
+    while (start < buffer.size()) {
+      std::size_t end = buffer.find('\n', start);
+      end = end == std::string::npos ? buffer.size() : end;
+      std::size_t last = end;
+      while (last > start && (buffer[last - 1] == '\r' ||
+                              buffer[last - 1] == ' ' ||
+                              buffer[last - 1] == '\t')) {
+        --last;
+      }
+      while (start < last && (buffer[start] == ' ' || buffer[start] == '\t')) {
+        ++start;
+      }
+      if (start < last && buffer[start] != '#') {
+        buffer[last] = '\0';
+        version->argv.push_back(buffer.data() + start);
+      } else if (last < buffer.size()) {
+        buffer[last] = '\0';
+      }
+      start = end + 1;
+    }
+    version->parser.parse(static_cast<int>(version->argv.size()),
+                          version->argv.data());
+    // Published versions are read concurrently and must not convert or map
+    // files lazily
+    version->parser.validateAll();
+    publish(std::move(version));
+  }
+
+  auto reloadFile(const char* path) -> void {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      detail::raise<std::invalid_argument>(
+          std::string("Cannot read config: ") + path);
+    }
+    reload(std::string(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>()));
+  }
+
+  // Versions replaced but not yet freed
+  [[nodiscard]] auto pendingReclaim() const -> std::size_t {
+    const std::lock_guard lock(writerMutex_);
+    return retired_.size();
+  }
+
+ private:
+  ParserType base_;
+  std::atomic<Version*> current_;
+  std::atomic<uint64_t> epoch_{1};
+  mutable std::array<Slot, MaxReaders> slots_{};
+  mutable std::mutex writerMutex_;
+  std::vector<Version*> retired_;
+
+  auto publish(std::unique_ptr<Version> version) -> void {
+    const std::lock_guard lock(writerMutex_);
+    Version* old =
+        current_.exchange(version.release(), std::memory_order_seq_cst);
+    old->retiredAt = epoch_.fetch_add(1, std::memory_order_seq_cst);
+    retired_.push_back(old);
+    reclaim();
+  }
+
+  // A reader pinned at epoch e may hold any version retired at e or later
+  auto reclaim() -> void {
+    uint64_t oldestPinned = UINT64_MAX;
+    for (const auto& slot : slots_) {
+      const uint64_t pinned = slot.epoch.load(std::memory_order_seq_cst);
+      if (pinned != 0) {
+        oldestPinned = std::min(oldestPinned, pinned);
+      }
+    }
+    const auto freed = std::stable_partition(
+        retired_.begin(), retired_.end(), [oldestPinned](Version* version) {
+          return version->retiredAt >= oldestPinned;
+        });
+    std::for_each(freed, retired_.end(), [](Version* version) {
+      delete version;
+    });
+    retired_.erase(freed, retired_.end());
+  }
+};
+
+// LiveOptions live(parser); the constructor takes a member alias, which
+// deduction cannot see through
+template <typename Parser>
+LiveOptions(const Parser&) -> LiveOptions<Parser>;
+
+#if ETCHED_HAS_INOTIFY
+
+// Reloads a LiveOptions from a config file whenever it is written or
+// replaced. Watches the containing directory so that editors saving through
+// a rename are seen too. Failed reloads go to `onError` and keep the
+// current values.
+template <typename Live>
+class ConfigWatcher {
+ public:
+  ConfigWatcher(Live& live, std::string path,
+                std::function<void(const std::exception&)> onError = {})
+      : live_(live), path_(std::move(path)), onError_(std::move(onError)) {
+    const std::size_t slash = path_.rfind('/');
+    const std::string dir =
+        slash == std::string::npos ? "." : path_.substr(0, slash + 1);
+    name_ = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+    fd_ = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0 || ::inotify_add_watch(fd_, dir.c_str(),
+                                       IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+      if (fd_ >= 0) {
+        ::close(fd_);
+      }
+      detail::raise<std::invalid_argument>("Cannot watch config: " + path_);
+    }
+    thread_ = std::jthread([this](const std::stop_token& stop) { run(stop); });
+  }
+
+  ConfigWatcher(const ConfigWatcher&) = delete;
+  auto operator=(const ConfigWatcher&) -> ConfigWatcher& = delete;
+
+  ~ConfigWatcher() {
+    thread_.request_stop();
+    thread_.join();
+    ::close(fd_);
+  }
+
+ private:
+  static constexpr int pollMillis = 100;
+
+  Live& live_;
+  std::string path_;
+  std::string name_;
+  std::function<void(const std::exception&)> onError_;
+  int fd_ = -1;
+  std::jthread thread_;
+
+  auto run(const std::stop_token& stop) -> void {
+    alignas(inotify_event) std::array<char, 4096> buffer{};  // NOLINT
+    while (!stop.stop_requested()) {
+      pollfd pfd{fd_, POLLIN, 0};
+      if (::poll(&pfd, 1, pollMillis) <= 0) {
+        continue;
+      }
+      bool changed = false;
+      ssize_t length = 0;
+      while ((length = ::read(fd_, buffer.data(), buffer.size())) > 0) {
+        for (ssize_t pos = 0; pos < length;) {
+          const auto* event =
+              reinterpret_cast<const inotify_event*>(buffer.data() + pos);  // NOLINT
+          if (event->len > 0 && name_ == event->name) {
+            changed = true;
+          }
+          pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+      }
+      if (changed) {
+#if ETCHED_EXCEPTIONS
+        try {
+          live_.reloadFile(path_.c_str());
+        } catch (const std::exception& error) {
+          if (onError_) {
+            onError_(error);
+          }
+        }
+#else
+        // Without exceptions a failed reload goes to the error handler
+        live_.reloadFile(path_.c_str());
+#endif
+      }
+    }
+  }
+};
+
+#endif
+
+}  // namespace etched
+
+#endif  // ETCHED_RELOAD_HPP
@@ -5,6 +5,8 @@
 #include <string>
 #include <utility>
 
+#include "errors.hpp"
+
 #ifndef ETCHED_SANITIZERS_HPP
 #define ETCHED_SANITIZERS_HPP
 
@@ -48,7 +50,8 @@ struct BasicSanitizer {
         ++cleanedArgc;
       } else {
         std::string argStr = arg ? std::string(arg) : "<null>";
-        throw std::invalid_argument("Invalid argument detected: " + argStr);
+        detail::raise<std::invalid_argument>(
+            "Invalid argument detected: " + argStr);
       }
     }
 
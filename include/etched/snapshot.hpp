@@ -0,0 +1,275 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <source_location>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "composite.hpp"
+#include "errors.hpp"
+#include "features.hpp"
+#include "files.hpp"
+#include "keyvalues.hpp"
+#include "units.hpp"
+
+#ifndef ETCHED_SNAPSHOT_HPP
+#define ETCHED_SNAPSHOT_HPP
+
+namespace etched::detail {
+
+constexpr std::array<char, 4> snapshotMagic = {'E', 'T', 'C', 'H'};
+constexpr uint32_t snapshotVersion = 2;
+
+constexpr auto hash64(std::string_view bytes, uint64_t hash) -> uint64_t {
+  constexpr uint64_t prime = 1099511628211ULL;
+  for (const char c : bytes) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * prime;
+  }
+  return hash;
+}
+
+// Compiler-specific spelling of T, stable within one build
+template <typename T>
+consteval auto typeName() -> std::string_view {
+  return std::source_location::current().function_name();
+}
+
+// Hash over the tags and value types of a parser's options. A blob restores
+// only into a parser with the same options built by the same compiler.
+template <IsOption... Options>
+consteval auto schemaHash() -> uint64_t {
+  constexpr uint64_t offsetBasis = 14695981039346656037ULL;
+  uint64_t hash = hash64({snapshotMagic.data(), snapshotMagic.size()},
+                         offsetBasis ^ snapshotVersion);
+  ((hash = hash64(typeName<typename Options::ValueType>(),
+                  hash64(Options::tag.view(), hash))),
+   ...);
+  return hash;
+}
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// Value types that serialize themselves
+template <typename T>
+concept CustomSnapshot =
+    requires(const T& value, SnapshotWriter& writer, SnapshotReader& reader) {
+      value.snapshot(writer);
+      { T::restore(reader) } -> std::same_as<T>;
+    };
+
+// Wrappers rebuilt from their underlying value, such as Bounded or EnumValue
+template <typename T>
+concept WrappedSnapshot = requires(const T& value) {
+  typename T::UnderlyingType;
+  { value.get() } -> std::convertible_to<typename T::UnderlyingType>;
+} && std::constructible_from<T, typename T::UnderlyingType>;
+
+// Enumerations restricted to a list of enumerators, such as EnumValue
+template <typename T>
+concept EnumListSnapshot = WrappedSnapshot<T> && requires {
+  { T::values.begin() } -> std::same_as<const typename T::UnderlyingType*>;
+};
+
+template <typename T>
+concept RawSnapshot = std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                      ChronoDuration<T> || FeatureSetValue<T>;
+
+template <typename T>
+concept StringSnapshot = std::same_as<T, std::string_view> ||
+                         std::same_as<T, const char*> ||
+                         std::same_as<T, std::string>;
+
+template <typename T>
+struct IsVector : std::false_type {};
+
+template <typename T>
+struct IsVector<std::vector<T>> : std::true_type {};
+
+template <typename T>
+concept TupleSnapshot = CompositeTraits<T>::value && !IsDelimited<T>::value;
+
+class SnapshotWriter {
+ public:
+  explicit SnapshotWriter(uint64_t schema) {
+    raw(snapshotMagic);
+    raw(snapshotVersion);
+    raw(schema);
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  auto raw(const T& value) -> void {
+    const auto* first = reinterpret_cast<const std::byte*>(&value);  // NOLINT
+    bytes_.insert(bytes_.end(), first, first + sizeof(T));
+  }
+
+  // Length-prefixed and NUL-terminated, so restored views can serve as C
+  // strings
+  auto string(std::string_view str) -> void {
+    raw(static_cast<uint64_t>(str.size()));
+    const auto* first = reinterpret_cast<const std::byte*>(str.data());  // NOLINT
+    bytes_.insert(bytes_.end(), first, first + str.size());
+    bytes_.push_back(std::byte{0});
+  }
+
+  template <typename T>
+  auto value(const T& value) -> void {
+    if constexpr (CustomSnapshot<T>) {
+      value.snapshot(*this);
+    } else if constexpr (RawSnapshot<T>) {
+      raw(value);
+    } else if constexpr (StringSnapshot<T>) {
+      string(value);
+    } else if constexpr (KeyValueMapValue<T>) {
+      raw(static_cast<uint64_t>(value.size()));
+      for (const auto& [key, setting] : value) {
+        string(key);
+        string(setting);
+      }
+    } else if constexpr (std::same_as<T, FileContents>) {
+      string(value.path());
+    } else if constexpr (IsVector<T>::value) {
+      raw(static_cast<uint64_t>(value.size()));
+      for (const auto& element : value) {
+        this->value(element);
+      }
+    } else if constexpr (TupleSnapshot<T>) {
+      std::apply([this](const auto&... elements) { (this->value(elements), ...); },
+                 value);
+    } else {
+      static_assert(WrappedSnapshot<T>, "Value type cannot be snapshotted");
+      this->value(static_cast<typename T::UnderlyingType>(value.get()));
+    }
+  }
+
+  auto take() -> std::vector<std::byte> { return std::move(bytes_); }
+
+ private:
+  std::vector<std::byte> bytes_;
+};
+
+// Reads a blob written by SnapshotWriter. Restored strings view the blob,
+// which must outlive the values read from it.
+class SnapshotReader {
+ public:
+  SnapshotReader(std::span<const std::byte> blob, uint64_t schema)
+      : blob_(blob) {
+    if (raw<std::array<char, 4>>() != snapshotMagic) {
+      detail::raise<std::invalid_argument>("Not an option snapshot");
+    }
+    if (raw<uint32_t>() != snapshotVersion) {
+      detail::raise<std::invalid_argument>("Unsupported snapshot version");
+    }
+    if (raw<uint64_t>() != schema) {
+      detail::raise<std::invalid_argument>(
+          "Snapshot was taken with other options");
+    }
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  auto raw() -> T {
+    T value;
+    std::memcpy(&value, take(sizeof(T)), sizeof(T));
+    return value;
+  }
+
+  auto string() -> std::string_view {
+    const auto size = raw<uint64_t>();
+    if (size >= blob_.size()) {
+      detail::raise<std::invalid_argument>("Truncated snapshot");
+    }
+    const auto* data = reinterpret_cast<const char*>(  // NOLINT
+        take(static_cast<std::size_t>(size) + 1));
+    return {data, static_cast<std::size_t>(size)};
+  }
+
+  template <typename T>
+  auto value() -> T {
+    if constexpr (CustomSnapshot<T>) {
+      return T::restore(*this);
+    } else if constexpr (std::same_as<T, bool>) {
+      // Any other byte is not a valid bool
+      const auto byte = raw<uint8_t>();
+      if (byte > 1) {
+        detail::raise<std::invalid_argument>("Corrupt snapshot: invalid bool");
+      }
+      return byte == 1;
+    } else if constexpr (std::is_enum_v<T>) {
+      return static_cast<T>(raw<std::underlying_type_t<T>>());
+    } else if constexpr (EnumListSnapshot<T>) {
+      const auto value = this->value<typename T::UnderlyingType>();
+      if (std::find(T::values.begin(), T::values.end(), value) ==
+          T::values.end()) {
+        detail::raise<std::invalid_argument>(
+            "Corrupt snapshot: unknown enumerator");
+      }
+      return T(value);
+    } else if constexpr (RawSnapshot<T>) {
+      return raw<T>();
+    } else if constexpr (std::same_as<T, const char*>) {
+      return string().data();
+    } else if constexpr (StringSnapshot<T>) {
+      return T(string());
+    } else if constexpr (KeyValueMapValue<T>) {
+      const auto size = raw<uint64_t>();
+      T map;
+      for (uint64_t i = 0; i < size; ++i) {
+        const std::string_view key = string();
+        map.insert(key, string());
+      }
+      return map;
+    } else if constexpr (std::same_as<T, FileContents>) {
+      return FileContents(string().data());
+    } else if constexpr (IsVector<T>::value) {
+      const auto size = raw<uint64_t>();
+      if (size > blob_.size() - pos_) {
+        detail::raise<std::invalid_argument>("Truncated snapshot");
+      }
+      T values;
+      values.reserve(static_cast<std::size_t>(size));
+      for (uint64_t i = 0; i < size; ++i) {
+        values.push_back(value<typename T::value_type>());
+      }
+      return values;
+    } else if constexpr (TupleSnapshot<T>) {
+      return [this]<std::size_t... I>(std::index_sequence<I...>) -> T {
+        return T{value<std::tuple_element_t<I, T>>()...};
+      }(std::make_index_sequence<std::tuple_size_v<T>>{});
+    } else {
+      static_assert(WrappedSnapshot<T>, "Value type cannot be snapshotted");
+      return T(value<typename T::UnderlyingType>());
+    }
+  }
+
+  [[nodiscard]] auto done() const -> bool { return pos_ == blob_.size(); }
+
+ private:
+  std::span<const std::byte> blob_;
+  std::size_t pos_ = 0;
+
+  auto take(std::size_t size) -> const std::byte* {
+    if (size > blob_.size() - pos_) {
+      detail::raise<std::invalid_argument>("Truncated snapshot");
+    }
+    const std::byte* data = blob_.data() + pos_;
+    pos_ += size;
+    return data;
+  }
+};
+
+}  // namespace etched::detail
+
+#endif  // ETCHED_SNAPSHOT_HPP
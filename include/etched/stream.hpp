@@ -0,0 +1,191 @@
+#pragma once
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "errors.hpp"
+#include "parse_state.hpp"
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+
+#ifndef ETCHED_STREAM_HPP
+#define ETCHED_STREAM_HPP
+
+namespace etched {
+
+// An argument read by parseStream() that the parser does not keep
+struct StreamArg {
+  static constexpr std::size_t positional = SIZE_MAX;
+
+  // Declaration index of the repeatable option the text is a value of, or
+  // `positional`
+  std::size_t option = positional;
+  std::string_view text;
+};
+
+// Owns the text that values parsed by parseStream() view: one slot per
+// option, plus every value of accumulating options. It must outlive them, as
+// argv must for parse(); moving it keeps the text in place.
+template <std::size_t K>
+class StreamText {
+ public:
+  StreamText() = default;
+  StreamText(const StreamText&) = delete;
+  StreamText(StreamText&&) noexcept = default;
+  auto operator=(const StreamText&) -> StreamText& = delete;
+  auto operator=(StreamText&&) noexcept -> StreamText& = default;
+  ~StreamText() = default;
+
+  // Replaces the text kept for option idx and returns the copy
+  auto retain(std::size_t idx, const char* text) -> const char* {
+    auto& slot = slots_[idx];
+    slot.assign(text, text + std::strlen(text) + 1);
+    return slot.data();
+  }
+
+  // Adds a copy of a value of an accumulating option and returns it
+  auto keep(const char* text) -> const char* {
+    return kept_.emplace_back(text, text + std::strlen(text) + 1).data();
+  }
+
+ private:
+  std::array<std::vector<char>, K> slots_{};
+  // Moving a vector<char> on growth keeps its buffer, so copies stay put
+  std::vector<std::vector<char>> kept_;
+};
+
+namespace detail {
+
+// Arguments handed to the callback of parseStream() at a time
+inline constexpr std::size_t streamBatchSize = 256;
+
+// Collects StreamArgs that view the current read buffer and hands them to
+// `onBatch` when full and before the buffer is reused
+template <typename OnBatch>
+class StreamBatch {
+ public:
+  explicit StreamBatch(OnBatch& onBatch) : onBatch_(onBatch) {}
+
+  auto push(std::size_t option, std::string_view text) -> void {
+    args_[count_++] = StreamArg{.option = option, .text = text};
+    if (count_ == args_.size()) {
+      flush();
+    }
+  }
+
+  auto flush() -> void {
+    if (count_ > 0) {
+      const std::size_t count = count_;
+      count_ = 0;
+      onBatch_(std::span<const StreamArg>(args_.data(), count));
+    }
+  }
+
+ private:
+  OnBatch& onBatch_;
+  std::array<StreamArg, streamBatchSize> args_{};
+  std::size_t count_ = 0;
+};
+
+// Hooks of parseStream(): option values are copied into `text`, and values
+// of accumulating options are also handed to `batch`
+template <std::size_t K, typename Batch>
+struct StreamContext {
+  StreamText<K>* text;
+  Batch* batch;
+
+  [[nodiscard]] auto hooks() -> ValueHooks {
+    return ValueHooks{
+        .context = this,
+        .retain = [](void* ctx, std::size_t idx,
+                     const char* value) -> const char* {
+          return static_cast<StreamContext*>(ctx)->text->retain(idx, value);
+        },
+        .keep = [](void* ctx, std::size_t /*unused*/,
+                   const char* value) -> const char* {
+          return static_cast<StreamContext*>(ctx)->text->keep(value);
+        },
+        .repeat = [](void* ctx, std::size_t idx, const char* value) -> void {
+          static_cast<StreamContext*>(ctx)->batch->push(idx, value);
+        }};
+  }
+};
+
+inline auto readSome(int fd, char* buffer, std::size_t size) -> long {
+#if __has_include(<unistd.h>)
+  return static_cast<long>(::read(fd, buffer, size));
+#else
+  return static_cast<long>(::_read(fd, buffer, static_cast<unsigned>(size)));
+#endif
+}
+
+// Reads NUL-terminated tokens from fd until end of file through a buffer of
+// ChunkSize bytes, calling onToken with each token, terminated in place, and
+// drained() once the tokens seen so far are done with, before the buffer is
+// reused. A token cut by the end of a read is moved to the front of the
+// buffer and completed by the next one; a final token may lack its NUL.
+template <std::size_t ChunkSize, typename OnToken, typename OnDrained>
+  requires(ChunkSize > 0)
+auto readTokens(int fd, OnToken&& onToken, OnDrained&& drained) -> void {
+  // One spare byte terminates a final token that filled the buffer
+  const auto buffer = std::make_unique<char[]>(ChunkSize + 1);  // NOLINT
+  std::size_t filled = 0;
+  while (true) {
+    const long got = readSome(fd, buffer.get() + filled, ChunkSize - filled);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+#if ETCHED_EXCEPTIONS
+      throw std::system_error(errno, std::generic_category(),
+                              "Cannot read argument stream");
+#else
+      detail::raise<std::system_error>(
+          std::string("Cannot read argument stream: ") + std::strerror(errno));
+#endif
+    }
+    const std::size_t end = filled + static_cast<std::size_t>(got);
+    std::size_t start = 0;
+    if (got == 0) {
+      if (end > 0) {
+        buffer[end] = '\0';
+        onToken(static_cast<const char*>(buffer.get()));
+      }
+      drained();
+      return;
+    }
+    for (std::size_t i = filled; i < end; ++i) {
+      if (buffer[i] == '\0') {
+        onToken(static_cast<const char*>(buffer.get() + start));
+        start = i + 1;
+      }
+    }
+    drained();
+    filled = end - start;
+    if (filled == ChunkSize) {
+      detail::raise<std::invalid_argument>(
+          "Argument longer than the stream chunk size of " +
+          std::to_string(ChunkSize) + " bytes");
+    }
+    std::memmove(buffer.get(), buffer.get() + start, filled);
+  }
+}
+
+}  // namespace detail
+
+}  // namespace etched
+
+#endif  // ETCHED_STREAM_HPP
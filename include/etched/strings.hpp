@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 
 #ifndef ETCHED_STRINGS_HPP
@@ -28,6 +30,10 @@ struct String {
 
   constexpr operator const char*() const { return data.data(); }
 
+  [[nodiscard]] constexpr auto view() const -> std::string_view {
+    return {data.data(), N - 1};
+  }
+
   static consteval auto isSpace(char c) -> bool {
     return c == ' ' || c == '\t' || c == '\n';
   }
@@ -73,13 +79,18 @@ constexpr auto operator==(const String<N>& s1, const char (&s2)[M]) -> bool {
 
 template <std::size_t N, std::size_t M>
 constexpr auto operator==(const char (&s1)[M], const String<N>& s2) -> bool {
-  auto str1 = String(s1);
-  return str1 == s2;
+  return s2 == s1;
 }
 
 template <std::size_t N>
 String(const char (&)[N]) -> String<N>;  // NOLINT
 
+template <typename T>
+struct IsStringType : std::false_type {};
+
+template <std::size_t N>
+struct IsStringType<String<N>> : std::true_type {};
+
 // String helper functions
 
 template <String str>
@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "lookup.hpp"
+
+#ifndef ETCHED_SUGGESTIONS_HPP
+#define ETCHED_SUGGESTIONS_HPP
+
+namespace etched::detail {
+
+// Myers' bit-parallel edit distance (Hyyro's formulation for global
+// Levenshtein distance). The pattern is encoded once into per-character
+// bitmasks and every candidate text is scanned in O(text length).
+struct EditDistance {
+  static constexpr std::size_t maxPattern = 64;
+  static constexpr std::size_t alphabet = 128;
+
+  std::array<std::uint64_t, alphabet> peq{};
+  std::size_t length = 0;
+
+  // Patterns longer than maxPattern are not encoded; distance() then reports
+  // every text as unreachable.
+  constexpr explicit EditDistance(std::string_view pattern)
+      : length(pattern.size()) {
+    if (length > maxPattern) {
+      return;
+    }
+    for (std::size_t i = 0; i < length; ++i) {
+      const auto code = static_cast<unsigned char>(pattern[i]);
+      if (code < alphabet) {
+        peq[code] |= std::uint64_t{1} << i;
+      }
+    }
+  }
+
+  [[nodiscard]] constexpr auto distance(std::string_view text) const
+      -> std::size_t {
+    if (length > maxPattern) {
+      return SIZE_MAX;
+    }
+    if (length == 0) {
+      return text.size();
+    }
+    const std::uint64_t mask =
+        length == maxPattern ? ~std::uint64_t{0}
+                             : (std::uint64_t{1} << length) - 1;
+    const std::uint64_t last = std::uint64_t{1} << (length - 1);
+    std::uint64_t pv = mask;
+    std::uint64_t mv = 0;
+    std::size_t score = length;
+    for (const char c : text) {
+      const auto code = static_cast<unsigned char>(c);
+      const std::uint64_t eq = code < alphabet ? peq[code] : 0;
+      const std::uint64_t xv = eq | mv;
+      const std::uint64_t xh = ((((eq & pv) + pv) & mask) ^ pv) | eq;
+      std::uint64_t ph = mv | (~(xh | pv) & mask);
+      std::uint64_t mh = pv & xh;
+      if ((ph & last) != 0) {
+        ++score;
+      } else if ((mh & last) != 0) {
+        --score;
+      }
+      ph = ((ph << 1) | 1) & mask;
+      mh = (mh << 1) & mask;
+      pv = mh | (~(xv | ph) & mask);
+      mv = ph & xv;
+    }
+    return score;
+  }
+};
+
+// Closest long names to a mistyped one, in declaration order
+struct Suggestions {
+  static constexpr std::size_t maxCount = 3;
+
+  std::array<std::size_t, maxCount> idx{};
+  std::size_t count = 0;
+  std::size_t distance = SIZE_MAX;
+};
+
+// Distances above this are too far off to be a typo of `name`
+constexpr auto maxSuggestionDistance(std::size_t length) -> std::size_t {
+  constexpr std::size_t cap = 3;
+  return std::min(cap, std::max<std::size_t>(1, length / 2));
+}
+
+template <std::size_t K>
+constexpr auto suggest(const OptionIndex<K>& index, std::string_view name)
+    -> Suggestions {
+  Suggestions result{};
+  const std::size_t limit = maxSuggestionDistance(name.size());
+  const EditDistance pattern(name);
+  for (std::size_t i = 0; i < K; ++i) {
+    const std::string_view candidate = index.longNames[i];
+    if (candidate.empty()) {
+      continue;
+    }
+    // Length difference is a lower bound on the distance
+    const std::size_t lengthGap = candidate.size() > name.size()
+                                      ? candidate.size() - name.size()
+                                      : name.size() - candidate.size();
+    if (lengthGap > limit || lengthGap > result.distance) {
+      continue;
+    }
+    const std::size_t dist = pattern.distance(candidate);
+    if (dist > limit || dist > result.distance) {
+      continue;
+    }
+    if (dist < result.distance) {
+      result.distance = dist;
+      result.count = 0;
+    }
+    if (result.count < Suggestions::maxCount) {
+      result.idx[result.count++] = i;
+    }
+  }
+  return result;
+}
+
+// Appends a "did you mean" hint naming the long options closest to `name`
+template <std::size_t K>
+auto appendSuggestions(std::string& message, std::string_view name,
+                       const OptionIndex<K>& index) -> void {
+  const Suggestions found = suggest(index, name);
+  for (std::size_t i = 0; i < found.count; ++i) {
+    message += i == 0 ? " (did you mean --" : " or --";
+    message += index.longNames[found.idx[i]];
+  }
+  if (found.count > 0) {
+    message += "?)";
+  }
+}
+
+}  // namespace etched::detail
+
+#endif  // ETCHED_SUGGESTIONS_HPP
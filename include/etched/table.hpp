@@ -0,0 +1,303 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "bounded.hpp"
+#include "composite.hpp"
+#include "concepts.hpp"
+#include "constraints.hpp"
+#include "converters.hpp"
+#include "counts.hpp"
+#include "enums.hpp"
+#include "errors.hpp"
+#include "features.hpp"
+#include "files.hpp"
+#include "keyvalues.hpp"
+#include "lists.hpp"
+#include "parse_state.hpp"
+#include "trace.hpp"
+#include "units.hpp"
+
+#ifndef ETCHED_TABLE_HPP
+#define ETCHED_TABLE_HPP
+
+namespace etched::detail {
+
+// Stores `text` into a type-erased std::optional<T>; flags and counts are
+// given null
+using StoreFn = void (*)(void* value, const char* text);
+using HintFn = void (*)(std::ostream& os);
+
+template <typename T>
+auto storeInto(void* value, const char* text) -> void {
+  auto& current = *static_cast<std::optional<T>*>(value);
+  if constexpr (std::is_same_v<T, bool>) {
+    current = true;
+  } else if constexpr (CountingValue<T>) {
+    T::increment(current);
+  } else if constexpr (AccumulatingValue<T>) {
+    T::accumulate(current, text);
+  } else {
+    current = fromStr<T>(text);
+  }
+}
+
+// One option of an OptionTable. Everything type-specific is behind the
+// function pointers, which are shared by all options of a value type.
+struct TableEntry {
+  static constexpr std::uint8_t takesValue = 1U;
+  // help or version: nothing may follow it
+  static constexpr std::uint8_t terminal = 2U;
+  static constexpr std::uint8_t help = 4U;
+
+  char shortFlag = '\0';
+  // Without the leading "--"
+  std::string_view longName;
+  const char* description = nullptr;
+  StoreFn store = nullptr;
+  HintFn hint = nullptr;
+  std::uint8_t flags = 0;
+};
+
+// Option metadata of a parser as data, for TableParserStrategy
+template <std::size_t K>
+struct OptionTable {
+  std::array<TableEntry, K> entries{};
+
+  template <IsOption... Options>
+    requires(sizeof...(Options) == K)
+  static constexpr auto build(const Options&... opts) -> OptionTable {
+    OptionTable table;
+    std::size_t idx = 0;
+    ((table.entries[idx++] = entry(opts)), ...);
+    return table;
+  }
+
+ private:
+  template <IsOption Opt>
+  static constexpr auto entry(const Opt& opt) -> TableEntry {
+    using ValueType = typename Opt::ValueType;
+    TableEntry result;
+    if (opt.shortName) {
+      const char* shortName = opt.shortName.value();
+      if (shortName[0] == '-' && shortName[1] != '-' && shortName[1] != '\0') {
+        result.shortFlag = shortName[1];
+      }
+    }
+    if (opt.longName) {
+      const char* longName = opt.longName.value();
+      if (longName[0] == '-' && longName[1] == '-' && longName[2] != '\0') {
+        result.longName = std::string_view(longName + 2);
+      }
+    }
+    result.description = opt.description.value_or(nullptr);
+    result.store = &storeInto<ValueType>;
+    if constexpr (HasValueHint<ValueType>) {
+      result.hint = &ValueType::printValueHint;
+    }
+    if constexpr (!std::is_same_v<ValueType, bool> &&
+                  !CountingValue<ValueType>) {
+      result.flags |= TableEntry::takesValue;
+    }
+    if constexpr (Opt::tag == "help" || Opt::tag == "version") {
+      result.flags |= TableEntry::terminal;
+    }
+    if constexpr (Opt::tag == "help") {
+      result.flags |= TableEntry::help;
+    }
+    return result;
+  }
+};
+
+// Where parsed values go: per option its std::optional value, its callback
+// trigger or null, and the words of the seen mask
+struct TableTargets {
+  void* const* values;
+  bool* const* triggers;
+  std::uint64_t* seen;
+};
+
+inline auto printTableHelp(std::span<const TableEntry> table) -> void {
+  for (const TableEntry& entry : table) {
+    if (entry.shortFlag != '\0') {
+      std::cout << '-' << entry.shortFlag;
+    }
+    if (!entry.longName.empty()) {
+      if (entry.shortFlag != '\0') {
+        std::cout << ", ";
+      }
+      std::cout << "--" << entry.longName;
+    }
+    if ((entry.flags & TableEntry::takesValue) != 0) {
+      std::cout << " <value>";
+    }
+    if (entry.hint != nullptr) {
+      std::cout << " ";
+      entry.hint(std::cout);
+    }
+    if (entry.description != nullptr) {
+      std::cout << "    " << entry.description;
+    }
+    std::cout << "\n";
+  }
+}
+
+// How much input an entry consumed besides its own flag
+enum class TableConsumed : std::uint8_t { NONE, ATTACHED, NEXT };
+
+inline auto applyEntry(std::span<const TableEntry> table, std::size_t idx,
+                       const char* arg, const char* attached,
+                       const char* next, const TableTargets& targets)
+    -> TableConsumed {
+  const TableEntry& entry = table[idx];
+  targets.seen[idx / 64] |= std::uint64_t{1} << (idx % 64);  // NOLINT
+  if ((entry.flags & TableEntry::terminal) != 0 &&
+      (attached != nullptr || next != nullptr)) {
+    detail::raise<std::invalid_argument>(
+        std::string("No arguments allowed after terminal option: ") + arg);
+  }
+  if (targets.triggers[idx] != nullptr) {
+    // Run by the parser once the whole command line has been accepted
+    *targets.triggers[idx] = true;
+  }
+  if ((entry.flags & TableEntry::help) != 0) {
+    printTableHelp(table);
+    std::exit(0);
+  }
+  if ((entry.flags & TableEntry::takesValue) == 0) {
+    entry.store(targets.values[idx], nullptr);
+    return TableConsumed::NONE;
+  }
+  if (attached != nullptr) {
+    entry.store(targets.values[idx], attached);
+    return TableConsumed::ATTACHED;
+  }
+  if (next != nullptr) {
+    entry.store(targets.values[idx], next);
+    return TableConsumed::NEXT;
+  }
+  detail::raise<std::invalid_argument>(
+      std::string("Option requires a value: ") + arg);
+}
+
+// The whole parse loop, compiled once for every parser that uses
+// TableParserStrategy. Names are found by a linear scan of the table.
+inline auto parseTable(int argc, const char* const* argv,  // NOLINT
+                       std::span<const TableEntry> table,
+                       const TableTargets& targets) -> void {
+  constexpr std::size_t npos = SIZE_MAX;
+  for (int i = 1; i < argc; ++i) {
+    const char* arg = argv[i];
+    const char* next = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg[0] != '-' || arg[1] == '\0') {
+      detail::raise<std::invalid_argument>(
+          std::string("Unexpected positional argument: ") + arg);
+    }
+    TableConsumed consumed = TableConsumed::NONE;
+    if (arg[1] == '-') {
+      const char* name = arg + 2;
+      const char* eq = std::strchr(name, '=');
+      const std::string_view key =
+          eq != nullptr ? std::string_view(name, eq - name) : name;
+      const char* attached = eq != nullptr ? eq + 1 : nullptr;
+      std::size_t idx = npos;
+      for (std::size_t n = 0; n < table.size() && idx == npos; ++n) {
+        if (!key.empty() && table[n].longName == key) {
+          idx = n;
+        }
+      }
+      if (idx == npos) {
+        detail::raise<std::invalid_argument>(
+            std::string("Unknown option: ") + arg);
+      }
+      consumed = applyEntry(table, idx, arg, attached, next, targets);
+      if (attached != nullptr && consumed == TableConsumed::NONE) {
+        detail::raise<std::invalid_argument>(
+            std::string("Option does not take a value: ") + arg);
+      }
+    } else {
+      for (const char* flag = arg + 1;
+           *flag != '\0' && consumed == TableConsumed::NONE; ++flag) {
+        std::size_t idx = npos;
+        for (std::size_t n = 0; n < table.size() && idx == npos; ++n) {
+          if (table[n].shortFlag == *flag) {
+            idx = n;
+          }
+        }
+        if (idx == npos) {
+          std::string message = std::string("Unknown option: -") + *flag;
+          if (flag != arg + 1) {
+            message += std::string(" in ") + arg;
+          }
+          detail::raise<std::invalid_argument>(message);
+        }
+        const char* attached = flag[1] != '\0' ? flag + 1 : nullptr;
+        consumed = applyEntry(table, idx, arg, attached, next, targets);
+      }
+    }
+    if (consumed == TableConsumed::NEXT) {
+      ++i;
+    }
+  }
+}
+
+// Trades speed for code size: option metadata lives in an OptionTable built
+// with the parser, one non-template loop parses every command line and
+// values are converted through one function per value type. Lookups scan
+// the table and unknown options get no suggestions. Values are converted
+// eagerly and no trace events are recorded.
+struct TableParserStrategy {
+  static constexpr bool tableDriven = true;
+
+  template <std::size_t N, IsOption... Options>
+  static auto parse(const int argc, std::array<const char*, N> argv,  // NOLINT
+                    Options&... opts) -> void {
+    const auto table = OptionTable<sizeof...(Options)>::build(opts...);
+    ParseState<sizeof...(Options)> state;
+    parse(argc, argv, table, state, opts...);
+  }
+
+  template <std::size_t N, std::size_t K, TracePolicy Trace,
+            IsOption... Options>
+    requires(K == sizeof...(Options))
+  static auto parse(const int argc, std::array<const char*, N> argv,  // NOLINT
+                    const OptionTable<K>& table, ParseState<K, Trace>& state,
+                    Options&... opts) -> void {
+    const std::array<void*, K> values = {static_cast<void*>(&opts.value)...};
+    const std::array<bool*, K> triggers = {trigger(opts)...};
+    parseTable(argc, argv.data(), table.entries,
+               TableTargets{.values = values.data(),
+                            .triggers = triggers.data(),
+                            .seen = state.seen.bits.data()});
+  }
+
+ private:
+  template <IsOption Opt>
+  static auto trigger(Opt& opt) -> bool* {
+    if constexpr (IsCallbackOption<Opt>) {
+      return &opt.triggered;
+    } else {
+      return nullptr;
+    }
+  }
+};
+
+template <typename T>
+concept TableStrategy = requires {
+  requires T::tableDriven;
+};
+
+}  // namespace etched::detail
+
+#endif  // ETCHED_TABLE_HPP
@@ -0,0 +1,139 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifndef ETCHED_TRACE_HPP
+#define ETCHED_TRACE_HPP
+
+namespace etched {
+
+enum class TraceStatus : std::uint8_t {
+  OK,
+  // No option has the flag's name
+  UNKNOWN_OPTION,
+  // The value was missing, not allowed or failed to convert
+  FAILED
+};
+
+// One option resolved from a command-line token. A cluster such as -abc
+// yields an event per flag, all with the same token index.
+struct TraceEvent {
+  // Index into argv
+  std::uint16_t token = 0;
+  // Declaration index of the option, or the option count if unresolved
+  std::uint16_t option = 0;
+  // Long names compared before the lookup finished; short flags are a
+  // single table index and report 0
+  std::uint16_t comparisons = 0;
+  TraceStatus status = TraceStatus::OK;
+  // Time spent storing the value, including its conversion unless a lazy
+  // strategy deferred it
+  std::uint64_t convertNanos = 0;
+};
+
+// Instrumentation policy of ArgumentParser. A policy with enabled == false
+// is never called and compiles out of the parse loop.
+template <typename T>
+concept TracePolicy = std::is_default_constructible_v<T> &&
+                      requires(T trace, const TraceEvent& event) {
+                        { T::enabled } -> std::convertible_to<bool>;
+                        trace.record(event);
+                      };
+
+// Default policy: no instrumentation
+struct NoTrace {
+  static constexpr bool enabled = false;
+
+  constexpr auto record(const TraceEvent& /*unused*/) -> void {}
+};
+
+// Forwards every event to a function, e.g. TraceSink<&logEvent>
+template <auto Sink>
+  requires std::invocable<decltype(Sink), const TraceEvent&>
+struct TraceSink {
+  static constexpr bool enabled = true;
+
+  auto record(const TraceEvent& event) -> void { Sink(event); }
+};
+
+// Keeps the last N events inside the parser, overwriting the oldest
+template <std::size_t N>
+  requires(N > 0)
+class TraceRing {
+ public:
+  static constexpr bool enabled = true;
+
+  constexpr auto record(const TraceEvent& event) -> void {
+    events_[written_ % N] = event;
+    ++written_;
+  }
+
+  [[nodiscard]] constexpr auto size() const -> std::size_t {
+    return std::min(written_, N);
+  }
+
+  // Events overwritten before they were read
+  [[nodiscard]] constexpr auto dropped() const -> std::size_t {
+    return written_ - size();
+  }
+
+  // i-th retained event, oldest first
+  [[nodiscard]] constexpr auto operator[](std::size_t i) const
+      -> const TraceEvent& {
+    return events_[(written_ - size() + i) % N];
+  }
+
+  constexpr auto clear() -> void { written_ = 0; }
+
+ private:
+  std::array<TraceEvent, N> events_{};
+  std::size_t written_ = 0;
+};
+
+// Parser strategy instrumented by a policy, e.g.
+// makeParser<Traced<detail::DefaultParserStrategy, TraceRing<64>>>(opts...)
+template <typename Strategy, TracePolicy Policy>
+struct Traced : Strategy {
+  using Trace = Policy;
+};
+
+namespace detail {
+
+// Instrumentation policy of a strategy: the one given to Traced, or NoTrace
+template <typename Strategy>
+struct StrategyTraceOf {
+  using type = NoTrace;
+};
+
+template <typename Strategy>
+  requires requires { typename Strategy::Trace; }
+struct StrategyTraceOf<Strategy> {
+  using type = typename Strategy::Trace;
+};
+
+template <typename Strategy>
+using StrategyTrace = typename StrategyTraceOf<Strategy>::type;
+
+struct NoTraceState {};
+
+// Where a traced parse sends events, and the token being parsed
+template <TracePolicy Trace>
+struct TraceState {
+  Trace* sink = nullptr;
+  std::uint16_t token = 0;
+  std::uint16_t comparisons = 0;
+};
+
+template <TracePolicy Trace>
+using TraceStateFor =
+    std::conditional_t<Trace::enabled, TraceState<Trace>, NoTraceState>;
+
+}  // namespace detail
+
+}  // namespace etched
+
+#endif  // ETCHED_TRACE_HPP
@@ -0,0 +1,401 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <ratio>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "composite.hpp"
+#include "converters.hpp"
+#include "errors.hpp"
+
+#ifndef ETCHED_UNITS_HPP
+#define ETCHED_UNITS_HPP
+
+namespace etched {
+
+namespace detail {
+
+template <typename T>
+struct IsChronoDuration : std::false_type {};
+
+template <typename Rep, typename Period>
+struct IsChronoDuration<std::chrono::duration<Rep, Period>> : std::true_type {
+};
+
+template <typename T>
+concept ChronoDuration = IsChronoDuration<T>::value;
+
+// Number with an optional fractional part, as in "1.5" of "1.5GiB"
+struct Decimal {
+  uint64_t whole = 0;
+  // Digits after the point, kept as text so scaling stays exact
+  std::string_view fraction;
+  std::size_t length = 0;
+};
+
+// Scans a decimal number from the start of `str`, stopping at the first
+// character that cannot belong to it
+constexpr auto scanDecimal(std::string_view str) -> Decimal {
+  constexpr uint64_t base = 10;
+  Decimal result{};
+  std::size_t pos = 0;
+  for (; pos < str.size() && str[pos] >= '0' && str[pos] <= '9'; ++pos) {
+    const auto digit = static_cast<uint64_t>(str[pos] - '0');
+    if (result.whole > (UINT64_MAX - digit) / base) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+    result.whole = result.whole * base + digit;
+  }
+  bool hasDigits = pos > 0;
+  if (pos < str.size() && str[pos] == '.') {
+    const std::size_t start = ++pos;
+    while (pos < str.size() && str[pos] >= '0' && str[pos] <= '9') {
+      ++pos;
+    }
+    result.fraction = str.substr(start, pos - start);
+    hasDigits = hasDigits || !result.fraction.empty();
+  }
+  if (!hasDigits) {
+    detail::raise<std::invalid_argument>("Expected a number");
+  }
+  result.length = pos;
+  return result;
+}
+
+// value * unit, checked for overflow; a product that is not a whole number
+// raises invalid_argument with `inexact`. The fraction is scaled in integer
+// arithmetic from its last digit up: each step divides digit * unit + carry
+// by 10, and the product is whole exactly when no step leaves a remainder,
+// so inputs such as "0.05s" come out exact.
+constexpr auto scaleDecimal(const Decimal& value, uint64_t unit,
+                            const char* inexact) -> uint64_t {
+  constexpr uint64_t base = 10;
+  if (value.whole > UINT64_MAX / unit) {
+    detail::raise<std::out_of_range>("Value out of range");
+  }
+  const uint64_t whole = value.whole * unit;
+  // carry < unit and units are at most 2^60, so nothing here overflows
+  uint64_t part = 0;
+  for (auto it = value.fraction.rbegin(); it != value.fraction.rend(); ++it) {
+    const uint64_t scaled = static_cast<uint64_t>(*it - '0') * unit + part;
+    if (scaled % base != 0) {
+      detail::raise<std::invalid_argument>(inexact);
+    }
+    part = scaled / base;
+  }
+  if (part > UINT64_MAX - whole) {
+    detail::raise<std::out_of_range>("Value out of range");
+  }
+  return whole + part;
+}
+
+// Bytes per unit for a size suffix, 0 if unknown. K, Ki and KiB are
+// binary multiples; kB and KB are decimal, as in dd(1).
+constexpr auto sizeUnit(std::string_view suffix) -> uint64_t {
+  if (suffix.empty()) {
+    return 1;
+  }
+  unsigned exponent = 0;
+  switch (suffix[0]) {
+    case 'B':
+      return suffix.size() == 1 ? 1 : 0;
+    case 'k':
+    case 'K':
+      exponent = 1;
+      break;
+    case 'M':
+      exponent = 2;
+      break;
+    case 'G':
+      exponent = 3;
+      break;
+    case 'T':
+      exponent = 4;
+      break;
+    case 'P':
+      exponent = 5;
+      break;
+    case 'E':
+      exponent = 6;
+      break;
+    default:
+      return 0;
+  }
+  constexpr uint64_t kibi = 1024;
+  constexpr uint64_t kilo = 1000;
+  uint64_t base = 0;
+  switch (suffix.size()) {
+    case 1:
+      base = kibi;
+      break;
+    case 2:
+      base = suffix[1] == 'B' ? kilo : (suffix[1] == 'i' ? kibi : 0);
+      break;
+    case 3:
+      base = suffix[1] == 'i' && suffix[2] == 'B' ? kibi : 0;
+      break;
+    default:
+      break;
+  }
+  uint64_t unit = base == 0 ? 0 : 1;
+  for (unsigned i = 0; i < exponent && unit != 0; ++i) {
+    unit *= base;
+  }
+  return unit;
+}
+
+// Nanoseconds per unit for a duration suffix, 0 if unknown
+constexpr auto durationUnit(std::string_view suffix) -> uint64_t {
+  constexpr uint64_t micro = 1'000;
+  constexpr uint64_t milli = 1'000'000;
+  constexpr uint64_t second = 1'000'000'000;
+  constexpr uint64_t minute = 60 * second;
+  constexpr uint64_t hour = 60 * minute;
+  constexpr uint64_t day = 24 * hour;
+  switch (suffix.size()) {
+    case 1:
+      switch (suffix[0]) {
+        case 's':
+          return second;
+        case 'm':
+          return minute;
+        case 'h':
+          return hour;
+        case 'd':
+          return day;
+        default:
+          return 0;
+      }
+    case 2:
+      if (suffix[1] != 's') {
+        return 0;
+      }
+      switch (suffix[0]) {
+        case 'n':
+          return 1;
+        case 'u':
+          return micro;
+        case 'm':
+          return milli;
+        default:
+          return 0;
+      }
+    case 3:
+      return suffix == "min" ? minute : 0;
+    default:
+      return 0;
+  }
+}
+
+// "64K", "1.5GiB", "4096"
+constexpr auto parseByteSize(std::string_view str) -> uint64_t {
+  const Decimal number = scanDecimal(str);
+  const uint64_t unit = sizeUnit(str.substr(number.length));
+  if (unit == 0) {
+    detail::raise<std::invalid_argument>("Unknown size suffix");
+  }
+  return scaleDecimal(number, unit, "Size is finer than the option's unit");
+}
+
+// "250ms", "2h30m", "1.5s". A bare number counts ticks of D.
+template <ChronoDuration D>
+auto parseDuration(std::string_view str) -> D {
+  using Rep = typename D::rep;
+  const Decimal first = scanDecimal(str);
+  if (first.length == str.size()) {
+    if constexpr (std::is_floating_point_v<Rep>) {
+      return D(fromView<Rep>(str));
+    } else {
+      return D(parseInteger<Rep>(str, std::numeric_limits<Rep>::min(),
+                                 std::numeric_limits<Rep>::max()));
+    }
+  }
+  uint64_t total = 0;
+  std::size_t pos = 0;
+  while (pos < str.size()) {
+    const Decimal number = scanDecimal(str.substr(pos));
+    pos += number.length;
+    const std::size_t suffixStart = pos;
+    while (pos < str.size() && str[pos] >= 'a' && str[pos] <= 'z') {
+      ++pos;
+    }
+    const uint64_t unit =
+        durationUnit(str.substr(suffixStart, pos - suffixStart));
+    if (unit == 0) {
+      detail::raise<std::invalid_argument>("Unknown duration unit");
+    }
+    const uint64_t part =
+        scaleDecimal(number, unit, "Duration is finer than the option's unit");
+    if (part > UINT64_MAX - total) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+    total += part;
+  }
+  if (total > static_cast<uint64_t>(INT64_MAX)) {
+    detail::raise<std::out_of_range>("Value out of range");
+  }
+  const std::chrono::nanoseconds nanos(static_cast<int64_t>(total));
+  if constexpr (std::is_floating_point_v<Rep>) {
+    return std::chrono::duration_cast<D>(nanos);
+  } else {
+    const auto value = std::chrono::duration_cast<D>(nanos);
+    if (std::chrono::duration_cast<std::chrono::nanoseconds>(value) != nanos) {
+      detail::raise<std::invalid_argument>(
+          "Duration is finer than the option's unit");
+    }
+    return value;
+  }
+}
+
+template <typename Period>
+constexpr auto durationSuffix() -> const char* {
+  if constexpr (std::is_same_v<Period, std::nano>) {
+    return "ns";
+  } else if constexpr (std::is_same_v<Period, std::micro>) {
+    return "us";
+  } else if constexpr (std::is_same_v<Period, std::milli>) {
+    return "ms";
+  } else if constexpr (std::is_same_v<Period, std::ratio<1>>) {
+    return "s";
+  } else if constexpr (std::is_same_v<Period, std::ratio<60>>) {  // NOLINT
+    return "m";
+  } else if constexpr (std::is_same_v<Period, std::ratio<3600>>) {  // NOLINT
+    return "h";
+  } else {
+    return "";
+  }
+}
+
+// Prints a byte count in the largest binary unit that divides it exactly
+inline auto printByteSize(std::ostream& os, uint64_t bytes) -> void {
+  constexpr std::array<const char*, 7> units = {"",    "KiB", "MiB", "GiB",
+                                                "TiB", "PiB", "EiB"};
+  constexpr uint64_t kibi = 1024;
+  std::size_t unit = 0;
+  while (bytes != 0 && bytes % kibi == 0 && unit + 1 < units.size()) {
+    bytes /= kibi;
+    ++unit;
+  }
+  os << bytes << units[unit];
+}
+
+}  // namespace detail
+
+// Byte count parsed from "4096", "64K", "1.5GiB" or "10MB", limited to
+// [Min, Max] bytes
+template <uint64_t Min = 0, uint64_t Max = UINT64_MAX>
+  requires(Min <= Max)
+class ByteSize {
+ public:
+  using UnderlyingType = uint64_t;
+  static constexpr uint64_t min = Min;
+  static constexpr uint64_t max = Max;
+
+  constexpr ByteSize(uint64_t bytes) : bytes_(bytes) {  // NOLINT
+    if (bytes < Min || bytes > Max) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+  }
+
+  constexpr operator uint64_t() const { return bytes_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> uint64_t { return bytes_; }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    if constexpr (Min == 0 && Max == UINT64_MAX) {
+      os << "(size)";
+    } else {
+      os << "[";
+      detail::printByteSize(os, Min);
+      os << "..";
+      detail::printByteSize(os, Max);
+      os << "]";
+    }
+  }
+
+ private:
+  uint64_t bytes_;
+};
+
+// std::chrono duration parsed from "250ms", "2h30m" or "1.5s", limited to
+// [Min, Max] ticks of D
+template <typename D,
+          typename D::rep Min = std::numeric_limits<typename D::rep>::lowest(),
+          typename D::rep Max = std::numeric_limits<typename D::rep>::max()>
+  requires detail::ChronoDuration<D> && (Min <= Max)
+class Duration {
+ public:
+  using UnderlyingType = D;
+  static constexpr D min = D(Min);
+  static constexpr D max = D(Max);
+
+  constexpr Duration(D value) : value_(value) {  // NOLINT
+    if (value < min || value > max) {
+      detail::raise<std::out_of_range>("Value out of range");
+    }
+  }
+
+  constexpr operator D() const { return value_; }  // NOLINT
+
+  [[nodiscard]] constexpr auto get() const -> D { return value_; }
+
+  static auto printValueHint(std::ostream& os) -> void {
+    using Limits = std::numeric_limits<typename D::rep>;
+    if constexpr (Min == Limits::lowest() && Max == Limits::max()) {
+      os << "(duration)";
+    } else {
+      constexpr const char* suffix =
+          detail::durationSuffix<typename D::period>();
+      os << "[" << Min << suffix << ".." << Max << suffix << "]";
+    }
+  }
+
+ private:
+  D value_;
+};
+
+namespace detail {
+
+template <typename T>
+struct IsUnitValue : std::false_type {};
+
+template <uint64_t Min, uint64_t Max>
+struct IsUnitValue<ByteSize<Min, Max>> : std::true_type {};
+
+template <typename D, typename D::rep Min, typename D::rep Max>
+struct IsUnitValue<Duration<D, Min, Max>> : std::true_type {};
+
+template <typename T>
+concept UnitValue = IsUnitValue<T>::value;
+
+}  // namespace detail
+
+template <detail::ChronoDuration T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  return detail::parseDuration<T>(str);
+}
+
+template <detail::UnitValue T>
+auto fromStr(const char* str) -> T {
+  if (!str) {
+    detail::raise<std::invalid_argument>("Null pointer passed to fromStr");
+  }
+  if constexpr (detail::ChronoDuration<typename T::UnderlyingType>) {
+    return T(detail::parseDuration<typename T::UnderlyingType>(str));
+  } else {
+    return T(detail::parseByteSize(str));
+  }
+}
+
+}  // namespace etched
+
+#endif  // ETCHED_UNITS_HPP
@@ -0,0 +1,251 @@
+// Replaces the global allocation functions with counting hooks, runs the
+// parser suite under them and checks that parse() of built-in types does not
+// touch the heap on the success path.
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iostream>
+#include <new>
+
+#include "configurations.hpp"
+#include "etched-parser-tests.hpp"
+
+namespace {
+
+std::atomic<std::size_t> allocations{0};
+
+}  // namespace
+
+#if defined(__GLIBC__)
+// glibc lets the executable interpose malloc; C code and the C++ runtime
+// allocate through these as well
+extern "C" {
+auto __libc_malloc(std::size_t size) -> void*;                  // NOLINT
+auto __libc_calloc(std::size_t count, std::size_t size) -> void*;  // NOLINT
+auto __libc_realloc(void* ptr, std::size_t size) -> void*;     // NOLINT
+
+auto malloc(std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+auto calloc(std::size_t count, std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+auto realloc(void* ptr, std::size_t size) noexcept -> void* {  // NOLINT
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+}
+#endif
+
+auto operator new(std::size_t size) -> void* {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size == 0 ? 1 : size)) {  // NOLINT
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+auto operator new[](std::size_t size) -> void* { return operator new(size); }
+
+auto operator delete(void* ptr) noexcept -> void { std::free(ptr); }  // NOLINT
+
+auto operator delete[](void* ptr) noexcept -> void {
+  std::free(ptr);  // NOLINT
+}
+
+auto operator delete(void* ptr, std::size_t /*unused*/) noexcept -> void {
+  std::free(ptr);  // NOLINT
+}
+
+auto operator delete[](void* ptr, std::size_t /*unused*/) noexcept -> void {
+  std::free(ptr);  // NOLINT
+}
+
+namespace etched::tests {
+
+// Parses `args` with a copy of `parser`, reads every value and throws if
+// anything was allocated in between
+template <typename Parser>
+auto expectNoAllocation(const Parser& parser,
+                        std::initializer_list<const char*> args,
+                        const char* failure) -> void {
+  std::array<const char*, 32> argv{"program"};
+  std::size_t argc = 1;
+  for (const char* arg : args) {
+    argv[argc++] = arg;
+  }
+  auto mutableParser = parser;
+  const std::size_t before = allocations.load(std::memory_order_relaxed);
+  mutableParser.parse(static_cast<int>(argc), argv.data());
+  mutableParser.validateAll();
+  static_cast<void>(mutableParser.getOptions());
+  if (allocations.load(std::memory_order_relaxed) != before) {
+    throw failure;
+  }
+}
+
+enum class Level : std::uint8_t { LOW, HIGH };
+
+std::size_t callbackRuns = 0;
+
+auto countCallback() -> void { ++callbackRuns; }
+
+auto typedCallback(const int& value) -> void {
+  callbackRuns += static_cast<std::size_t>(value);
+}
+
+auto builtInTypesTest() -> void {
+  constexpr auto parser = ArgumentParser(
+      optInt<"i8", int8_t>("-a", "--i8", "int8", 0),
+      optInt<"u16", uint16_t>("-b", "--u16", "uint16", 0),
+      optInt<"i64", int64_t>("-c", "--i64", "int64", 0),
+      optInt<"u64", uint64_t>("-d", "--u64", "uint64", 0),
+      optFloat<"f", float>("-e", "--float", "float", 0.0F),
+      optFloat<"d", double>("-f", "--double", "double", 0.0),
+      opt<char, "char">("-g", "--char", "char"),
+      optString<"str">("-s", "--str", "string"),
+      opt<std::string_view, "view">("-v", "--view", "view"),
+      optBool<"flag">("-x", "--flag", "flag"),
+      optCount<"verbose">("-V", "--verbose", "verbosity"));
+  expectNoAllocation(parser,
+                     {"-a", "-128", "--u16=65535", "-c",
+                      "-9223372036854775808", "--u64", "18446744073709551615",
+                      "-e", "3.25", "--double=-2.718281828459045", "-gz",
+                      "--str", "a string longer than any small buffer",
+                      "--view=another fairly long string value", "-xVVV"},
+                     "Built-in conversions allocated");
+}
+
+auto valueTypesTest() -> void {
+  constexpr auto parser = ArgumentParser(
+      opt<Bounded<int, 1, 100>, "percent">("-p", "--percent", "Percent", 50),
+      opt<OneOf<1, 2, 4, 8>, "workers">("-w", "--workers", "Workers", 4),
+      opt<OneOfStr<"fast", "safe">, "mode">("-m", "--mode", "Mode"),
+      optEnum<"level", Level, {"low", Level::LOW}, {"high", Level::HIGH}>(
+          "-l", "--level", "Level"),
+      opt<ByteSize<>, "size">("-s", "--size", "Size"),
+      opt<Duration<std::chrono::milliseconds>, "timeout">("-t", "--timeout",
+                                                          "Timeout"),
+      opt<std::pair<int, double>, "pair">("-P", "--pair", "Pair"),
+      opt<Delimited<std::array<int, 2>, 'x'>, "res">("-r", "--res",
+                                                     "Resolution"),
+      optFeatures<"features", "simd", "gpu", "trace">("-F", "--features",
+                                                      "Features"),
+      optMap<"set", 8>("-D", "--set", "Settings"));
+  expectNoAllocation(parser,
+                     {"-p", "99", "-w8", "--mode=safe", "-l", "high", "-s",
+                      "1.5GiB", "--timeout=2m30s", "-P", "3,0.5", "-r",
+                      "1920x1080", "-F", "simd,gpu", "-F", "-gpu", "-D",
+                      "threads=4", "--set", "name=etched"},
+                     "Value type conversions allocated");
+}
+
+auto parserFeaturesTest() -> void {
+  constexpr auto parser =
+      ArgumentParser(
+          optString<"input">("-i", "--input", "Input"),
+          optBool<"json">("-j", "--json", "JSON"),
+          optBool<"yaml">("-y", "--yaml", "YAML"),
+          optCallback<"count">("-c", "--count", "Count", countCallback),
+          optCallback<"typed", int>("-n", "--number", "Number",
+                                    typedCallback, 1))
+          .constrain(required<"input">(), exclusive<"json", "yaml">());
+  callbackRuns = 0;
+  expectNoAllocation(parser, {"-i", "file", "-j", "-c", "--number=2"},
+                     "Constraints or callbacks allocated");
+  if (callbackRuns != 3) {
+    throw "Callbacks did not run";
+  }
+  constexpr auto lazy = makeParser<detail::LazyParserStrategy>(
+      optInt<"port">("-p", "--port", "Port", 80),
+      optFloat<"rate", double>("-r", "--rate", "Rate", 1.0));
+  expectNoAllocation(lazy, {"-p", "8080", "--rate", "0.25"},
+                     "Lazy conversion allocated");
+  constexpr auto traced =
+      makeParser<Traced<detail::DefaultParserStrategy, TraceRing<8>>>(
+          optInt<"port">("-p", "--port", "Port", 80));
+  expectNoAllocation(traced, {"--port", "8080"}, "Tracing allocated");
+  constexpr auto wrapper = makeParser<detail::PassThroughParserStrategy>(
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1));
+  expectNoAllocation(wrapper, {"-j", "2", "--child", "file", "--", "-j"},
+                     "Pass-through allocated");
+  constexpr auto table = makeParser<detail::TableParserStrategy>(
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+      optString<"name">("-n", "--name", "Name"),
+      optBool<"verbose">("-v", "--verbose", "Verbose"));
+  expectNoAllocation(table, {"-vj", "2", "--name=node"},
+                     "Table-driven strategy allocated");
+}
+
+// The programs in examples/, with command lines they accept. Help, version
+// and the callbacks that print are left off the command lines: they exit or
+// write to stdout.
+auto exampleConfigurationsTest() -> void {
+  expectNoAllocation(examples::basicParsing(),
+                     {"--port", "3000", "-h", "127.0.0.1"},
+                     "01-basic-parsing allocated");
+  expectNoAllocation(examples::booleanFlags(), {"-vd", "--quiet"},
+                     "02-boolean-flags allocated");
+  expectNoAllocation(
+      examples::multipleTypes(),
+      {"-c", "5", "-r", "2.5", "-n", "alice", "--size", "4096"},
+      "03-multiple-types allocated");
+  expectNoAllocation(examples::helpOption(),
+                     {"-p", "80", "-c", "app.conf", "-v"},
+                     "04-help-option allocated");
+  expectNoAllocation(examples::versionOption(), {"--port=8081"},
+                     "05-version-option allocated");
+  expectNoAllocation(examples::customCallbacks(), {"-p", "9000"},
+                     "06-custom-callbacks allocated");
+  expectNoAllocation(
+      examples::valuesWithSpaces(),
+      {"-p", "/home/user/My Documents/file.txt", "--message",
+       "Hello from the command line", "-d", "A longer description"},
+      "07-values-with-spaces allocated");
+  expectNoAllocation(examples::errorHandling(), {"-p", "65535"},
+                     "08-error-handling allocated");
+  expectNoAllocation(
+      examples::integerRanges(),
+      {"-t", "-100", "-s", "30000", "-n", "2000000000", "-b",
+       "9000000000000000000", "-u", "200", "-p", "75", "-w", "2"},
+      "09-integer-ranges allocated");
+  expectNoAllocation(
+      examples::completeApplication(),
+      {"-H", "example.com", "--port=443", "-w", "16", "-t", "12.5", "-c",
+       "/etc/app.conf", "-vd"},
+      "10-complete-application allocated");
+  expectNoAllocation(examples::customTypes(),
+                     {"-p", "3.14,2.71", "--color", "#FF5733", "-v"},
+                     "11-custom-types allocated");
+}
+
+auto allocationTests() -> void {
+  builtInTypesTest();
+  valueTypesTest();
+  parserFeaturesTest();
+  exampleConfigurationsTest();
+}
+
+}  // namespace etched::tests
+
+auto main() -> int {
+  try {
+    // The whole suite must still pass with the hooks installed; its error
+    // paths and non-built-in types are free to allocate
+    etched::tests::parserTests();
+    etched::tests::allocationTests();
+  } catch (const char* message) {
+    std::cerr << message << "\n";
+    return 1;
+  }
+  std::cout << "No allocations on the success path.\n";
+  return 0;
+}
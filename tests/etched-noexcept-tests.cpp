@@ -0,0 +1,116 @@
+// Built with -fno-exceptions: parses through the whole library and checks
+// that runtime errors reach the handler set with setErrorHandler()
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <etched/etched.hpp>
+#include <initializer_list>
+#include <string>
+
+#if __has_include(<sys/wait.h>) && __has_include(<unistd.h>)
+#include <sys/wait.h>
+#include <unistd.h>
+#define ETCHED_TEST_FORK 1
+#else
+#define ETCHED_TEST_FORK 0
+#endif
+
+static_assert(ETCHED_EXCEPTIONS == 0, "Build this test with -fno-exceptions");
+
+namespace etched::tests {
+
+auto check(bool condition, const char* failure) -> void {
+  if (!condition) {
+    std::fputs(failure, stderr);
+    std::fputs("\n", stderr);
+    std::exit(1);
+  }
+}
+
+constexpr auto parser = ArgumentParser(
+    optInt<"port">("-p", "--port", "Port", 80),
+    optFloat<"rate", double>("-r", "--rate", "Rate", 1.0),
+    opt<Bounded<int, 1, 8>, "jobs">("-j", "--jobs", "Jobs", 1),
+    opt<ByteSize<>, "size">("-s", "--size", "Size"),
+    optBool<"verbose">("-v", "--verbose", "Verbose"));
+
+auto successTest() -> void {
+  const char* argv[] = {"program", "--port=8080", "-r", "0.5", "-vj4",
+                        "--size", "64K"};
+  auto mutableParser = parser;
+  mutableParser.parse(7, argv);
+  check(mutableParser.getOption<"port">().value.value() == 8080 &&
+            mutableParser.getOption<"rate">().value.value() == 0.5 &&
+            mutableParser.getOption<"jobs">().value.value() == 4 &&
+            mutableParser.getOption<"size">().value.value() == 65536 &&
+            mutableParser.getOption<"verbose">().value.value(),
+        "Values not parsed without exceptions");
+}
+
+#if ETCHED_TEST_FORK
+int reportFd = -1;
+
+// Writes the error to the parent and ends the child
+auto reportError(ErrorKind kind, const char* message) -> void {
+  const char prefix = kind == ErrorKind::OUT_OF_RANGE ? 'R' : 'I';
+  static_cast<void>(::write(reportFd, &prefix, 1));
+  static_cast<void>(::write(reportFd, message, std::strlen(message)));
+  ::_exit(0);
+}
+
+// Parses `args` in a child process and returns what reached the handler
+auto errorFor(std::initializer_list<const char*> args) -> std::string {
+  int fds[2];
+  check(::pipe(fds) == 0, "pipe() failed");
+  const pid_t pid = ::fork();
+  check(pid >= 0, "fork() failed");
+  if (pid == 0) {
+    ::close(fds[0]);
+    reportFd = fds[1];
+    setErrorHandler(reportError);
+    const char* argv[16] = {"program"};
+    int argc = 1;
+    for (const char* arg : args) {
+      argv[argc++] = arg;
+    }
+    auto mutableParser = parser;
+    mutableParser.parse(argc, argv);
+    ::_exit(2);
+  }
+  ::close(fds[1]);
+  std::string reply;
+  char buffer[256];
+  ssize_t length = 0;
+  while ((length = ::read(fds[0], buffer, sizeof(buffer))) > 0) {
+    reply.append(buffer, static_cast<std::size_t>(length));
+  }
+  ::close(fds[0]);
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  check(WIFEXITED(status) && WEXITSTATUS(status) == 0,
+        "Parse did not stop at the error handler");
+  return reply;
+}
+
+auto handlerTest() -> void {
+  check(errorFor({"--port", "x"}) == "IInvalid integer value",
+        "Conversion error not reported");
+  check(errorFor({"-j", "9"}) == "RValue out of range",
+        "Range error not reported");
+  check(errorFor({"--prot", "1"}).starts_with("IUnknown option: --prot"),
+        "Unknown option not reported");
+  check(errorFor({"-r"}) == "IOption requires a value: -r",
+        "Missing value not reported");
+}
+#endif
+
+}  // namespace etched::tests
+
+auto main() -> int {
+  etched::tests::successTest();
+#if ETCHED_TEST_FORK
+  etched::tests::handlerTest();
+#endif
+  std::puts("Exception-free build passed.");
+  return 0;
+}
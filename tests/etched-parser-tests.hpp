@@ -2,7 +2,20 @@
 #ifndef ETCHED_LIB_ETCHED_PARSER_TESTS_HPP
 #define ETCHED_LIB_ETCHED_PARSER_TESTS_HPP
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <etched/etched.hpp>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
 
 namespace etched::tests {
 
@@ -689,6 +702,80 @@ auto callbackTest() -> void {
   }
 }
 
+std::string globalCallbackTrace;
+int globalCallbackLevel = 0;
+
+auto deferredCallbackTest() -> void {
+  constexpr auto parser = ArgumentParser(
+      optCallback<"first">("-a", "--first", "First",
+                           [] { globalCallbackTrace += "a"; }),
+      optCallback<"early">(
+          "-b", "--early", "Early", [] { globalCallbackTrace += "b"; }, -1),
+      optCallback<"level", int>("-l", "--level", "Level",
+                                [](const int& level) {
+                                  globalCallbackTrace += "l";
+                                  globalCallbackLevel = level;
+                                }),
+      optInt<"port">("-p", "--port", "Port", 8080));
+  {
+    globalCallbackTrace.clear();
+    const char* argv[] = {"program", "-a", "--level=3", "-b", "-a"};
+    auto mutableParser = parser;
+    mutableParser.parse(5, argv);
+    if (globalCallbackTrace != "bal" || globalCallbackLevel != 3) {
+      throw "Callbacks not run once in priority and declaration order";
+    }
+  }
+  {
+    globalCallbackTrace.clear();
+    bool caught = false;
+    try {
+      const char* argv[] = {"program", "-a", "-l", "4", "--port=x"};
+      auto mutableParser = parser;
+      mutableParser.parse(5, argv);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught || !globalCallbackTrace.empty()) {
+      throw "Callbacks ran although parsing failed";
+    }
+  }
+  {
+    // A failed parse must not leave callbacks triggered for the next one
+    globalCallbackTrace.clear();
+    auto mutableParser = parser;
+    try {
+      const char* argv[] = {"program", "-a", "--port=x"};
+      mutableParser.parse(3, argv);
+    } catch (const std::invalid_argument&) {
+    }
+    const char* argv[] = {"program", "-b"};
+    mutableParser.parse(2, argv);
+    if (globalCallbackTrace != "b" || mutableParser.given<"first">()) {
+      throw "Callback of a failed parse ran after the next one";
+    }
+  }
+  {
+    // Lazy values are converted before any callback runs
+    globalCallbackTrace.clear();
+    bool caught = false;
+    try {
+      constexpr auto lazyParser = makeParser<detail::LazyParserStrategy>(
+          optCallback<"first">("-a", "--first", "First",
+                               [] { globalCallbackTrace += "a"; }),
+          optInt<"port">("-p", "--port", "Port", 8080));
+      const char* argv[] = {"program", "-a", "--port=x"};
+      auto mutableParser = lazyParser;
+      mutableParser.parse(3, argv);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught || !globalCallbackTrace.empty()) {
+      throw "Callbacks ran before lazy values were validated";
+    }
+  }
+}
+
 auto stringWithSpacesTest() -> void {
   {
     constexpr auto parser =
@@ -727,6 +814,999 @@ auto terminalOptionTest() -> void {
   }
 }
 
+auto bundledShortFlagsTest() -> void {
+  {
+    constexpr auto parser = ArgumentParser(
+        optBool<"all">("-a", "--all", "All"),
+        optBool<"brief">("-b", "--brief", "Brief"),
+        optInt<"jobs">("-j", "--jobs", "Jobs", 1));
+    const char* argv[] = {"program", "-abj8"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+    if (!mutableParser.getOption<"all">().value.value_or(false) ||
+        !mutableParser.getOption<"brief">().value.value_or(false)) {
+      throw "Bundled short flags not set";
+    }
+    if (mutableParser.getOption<"jobs">().value != 8) {
+      throw "Attached value in short cluster not parsed";
+    }
+  }
+  {
+    constexpr auto parser =
+        ArgumentParser(optBool<"all">("-a", "--all", "All"),
+                       optInt<"jobs">("-j", "--jobs", "Jobs", 1));
+    const char* argv[] = {"program", "-aj", "4"};
+    auto mutableParser = parser;
+    mutableParser.parse(3, argv);
+    if (mutableParser.getOption<"jobs">().value != 4) {
+      throw "Value after short cluster not parsed";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      constexpr auto parser =
+          ArgumentParser(optBool<"all">("-a", "--all", "All"));
+      const char* argv[] = {"program", "-ax"};
+      auto mutableParser = parser;
+      mutableParser.parse(2, argv);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Unknown flag in short cluster not detected";
+    }
+  }
+}
+
+auto countFlagTest() -> void {
+  static_assert(sizeof(Count<3>) == 1);
+  static_assert(sizeof(Count<1000>) == 2);
+  {
+    constexpr auto parser = ArgumentParser(
+        optCount<"verbose", 3>("-v", "--verbose", "Verbosity"),
+        optCount<"debug">("-d", "--debug", "Debug level"),
+        optBool<"all">("-a", "--all", "All"));
+    const char* argv[] = {"program", "-vav", "--verbose", "-d"};
+    auto mutableParser = parser;
+    mutableParser.parse(4, argv);
+    if (mutableParser.getOption<"verbose">().value.value() != 3 ||
+        mutableParser.getOption<"debug">().value.value() != 1 ||
+        !mutableParser.getOption<"all">().value.value_or(false)) {
+      throw "Counting flags not counted";
+    }
+  }
+  {
+    constexpr auto parser =
+        ArgumentParser(optCount<"verbose", 2>("-v", "--verbose", "Verbosity"));
+    const char* argv[] = {"program", "-vvvvv"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+    if (mutableParser.getOption<"verbose">().value.value() != 2) {
+      throw "Counting flag did not saturate";
+    }
+  }
+  {
+    constexpr auto parser =
+        ArgumentParser(optCount<"verbose">("-v", "--verbose", "Verbosity"));
+    const char* argv[] = {"program"};
+    auto mutableParser = parser;
+    mutableParser.parse(1, argv);
+    if (mutableParser.getOption<"verbose">().value.value() != 0) {
+      throw "Absent counting flag not zero";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      constexpr auto parser =
+          ArgumentParser(optCount<"verbose">("-v", "--verbose", "Verbosity"));
+      const char* argv[] = {"program", "--verbose=2"};
+      auto mutableParser = parser;
+      mutableParser.parse(2, argv);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Counting flag accepted a value";
+    }
+  }
+}
+
+auto liveReloadTest() -> void {
+  constexpr auto parser =
+      ArgumentParser(optInt<"low">("-l", "--low", "Low", 0),
+                     optInt<"high">("-h", "--high", "High", 0),
+                     optString<"name">("-n", "--name", "Name", "base"));
+  {
+    LiveOptions<decltype(parser), 4> live(parser);
+    const auto reader = live.registerReader();
+    live.reload("# limits\n  --low=5\r\n\n--name\nedge node\n");
+    {
+      const auto view = reader.read();
+      if (view.getOption<"low">().value != 5 ||
+          view.getOption<"high">().value != 0 ||
+          view->getOption<"name">().value != "edge node") {
+        throw "Live options not reloaded";
+      }
+      live.reload("--low=6");
+      if (view.getOption<"low">().value != 5 || live.pendingReclaim() != 1) {
+        throw "Pinned version not kept alive";
+      }
+    }
+    live.reload("--low=7");
+    if (live.pendingReclaim() != 0 ||
+        reader.read().getOption<"low">().value != 7) {
+      throw "Replaced versions not reclaimed";
+    }
+    bool caught = false;
+    try {
+      live.reload("--low=x");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught || reader.read().getOption<"low">().value != 7) {
+      throw "Failed reload replaced the current version";
+    }
+    std::vector<LiveOptions<decltype(parser), 4>::Reader> readers;
+    for (int i = 0; i < 3; ++i) {
+      readers.push_back(live.registerReader());
+    }
+    caught = false;
+    try {
+      static_cast<void>(live.registerReader());
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Reader slots not limited";
+    }
+  }
+  {
+    // Readers must always see low and high from the same version
+    LiveOptions live(parser);
+    using Deduced = LiveOptions<std::remove_cv_t<decltype(parser)>>;
+    static_assert(std::is_same_v<decltype(live), Deduced>);
+    std::atomic<bool> stop = false;
+    std::atomic<bool> torn = false;
+    std::vector<std::jthread> threads;
+    for (int i = 0; i < 3; ++i) {
+      threads.emplace_back([&live, &stop, &torn] {
+        const auto reader = live.registerReader();
+        while (!stop.load()) {
+          const auto view = reader.read();
+          if (view.getOption<"low">().value != view.getOption<"high">().value) {
+            torn = true;
+          }
+        }
+      });
+    }
+    for (int i = 1; i <= 200; ++i) {
+      const std::string n = std::to_string(i);
+      live.reload("--low=" + n + "\n--high=" + n);
+    }
+    stop = true;
+    threads.clear();
+    if (torn) {
+      throw "Reader saw a torn version";
+    }
+  }
+#if ETCHED_HAS_INOTIFY
+  {
+    const std::string path = "etched-live-reload-test.conf";
+    std::ofstream(path) << "--low=1\n";
+    LiveOptions<decltype(parser)> live(parser);
+    live.reloadFile(path.c_str());
+    const auto reader = live.registerReader();
+    {
+      ConfigWatcher watcher(live, path);
+      std::ofstream(path) << "--low=2\n";
+      const auto deadline =
+          std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (reader.read().getOption<"low">().value != 2 &&
+             std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    std::remove(path.c_str());
+    if (reader.read().getOption<"low">().value != 2) {
+      throw "Config change not picked up by watcher";
+    }
+  }
+#endif
+}
+
+constinit GlobalParser globalOptions{ArgumentParser(
+    optInt<"port">("-p", "--port", "Port", 80),
+    optString<"host">("-H", "--host", "Host", "localhost"),
+    optBool<"verbose">("-v", "--verbose", "Verbose"),
+    optList<"ids", int>("-i", "--ids", "IDs"))};
+
+auto globalParserTest() -> void {
+  bool caught = false;
+  try {
+    static_cast<void>(globalOptions.getOption<"port">());
+  } catch (const std::logic_error&) {
+    caught = true;
+  }
+  if (!caught || globalOptions.ready()) {
+    throw "Global options readable before parse()";
+  }
+  const char* bad[] = {"program", "-v", "-i", "1", "--port", "x"};
+  try {
+    globalOptions.parse(6, bad);
+  } catch (const std::invalid_argument&) {
+  }
+  const char* retry[] = {"program", "-i", "2", "--port", "8080"};
+  globalOptions.parse(5, retry);
+  if (globalOptions.getOption<"verbose">().value.value_or(false) ||
+      globalOptions.given<"verbose">() ||
+      globalOptions.getOption<"ids">().value->size() != 1) {
+    throw "Failed global parse left values behind";
+  }
+  const char* argv[] = {"program", "--port", "8080"};
+  std::atomic<int> mismatches{0};
+  {
+    std::vector<std::jthread> readers;
+    for (int t = 0; t < 4; ++t) {
+      readers.emplace_back([&mismatches] {
+        for (int i = 0; i < 1000; ++i) {
+          if (globalOptions.getOption<"port">().value != 8080 ||
+              std::string_view(*globalOptions.getOption<"host">().value) !=
+                  "localhost" ||
+              !globalOptions.given<"port">()) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+  }
+  if (mismatches != 0) {
+    throw "Published global options read wrong values";
+  }
+  caught = false;
+  try {
+    globalOptions.parse(3, argv);
+  } catch (const std::logic_error&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Second parse of global options not rejected";
+  }
+}
+
+auto lazyConversionTest() -> void {
+  constexpr auto parser = makeParser<detail::LazyParserStrategy>(
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+      optInt<"port">("-p", "--port", "Port"),
+      optBool<"dry">("-d", "--dry-run", "Dry run"),
+      optCount<"verbose">("-v", "--verbose", "Verbosity"),
+      optList<"ids", int>("-i", "--ids", "IDs"));
+  {
+    const char* argv[] = {"program", "-j", "8",   "--port=nope", "-dvv",
+                          "-i",      "1", "-i", "2"};
+    auto mutableParser = parser;
+    mutableParser.parse(9, argv);
+    if (!mutableParser.getOption<"dry">().value.value_or(false) ||
+        mutableParser.getOption<"verbose">().value.value() != 2 ||
+        mutableParser.getOption<"ids">().value->size() != 2) {
+      throw "Flags and accumulating values not applied while parsing";
+    }
+    if (std::get<0>(mutableParser.getOptions()).value != 1) {
+      throw "getOptions converted a lazy value";
+    }
+    if (mutableParser.getOption<"jobs">().value != 8) {
+      throw "Lazy value not converted on access";
+    }
+    for (int attempt = 0; attempt < 2; ++attempt) {
+      bool caught = false;
+      try {
+        static_cast<void>(mutableParser.getOption<"port">());
+      } catch (const std::invalid_argument&) {
+        caught = true;
+      }
+      if (!caught) {
+        throw "Lazy conversion error not reported on access";
+      }
+    }
+    bool caught = false;
+    try {
+      mutableParser.validateAll();
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "validateAll did not report a conversion error";
+    }
+  }
+  {
+    // Text of an earlier parse is not converted after the next one
+    const char* first[] = {"program", "-j", "x"};
+    auto mutableParser = parser;
+    mutableParser.parse(3, first);
+    const char* second[] = {"program"};
+    mutableParser.parse(1, second);
+    if (mutableParser.getOption<"jobs">().value != 1 ||
+        mutableParser.given<"jobs">()) {
+      throw "Pending text of an earlier parse kept";
+    }
+  }
+  {
+    const char* argv[] = {"program", "-j", "8", "-d", "--port", "nope"};
+    auto mutableParser = parser;
+    mutableParser.parse(6, argv);
+    const auto& constParser = mutableParser;
+    if (!constParser.getOption<"dry">().value.value_or(false)) {
+      throw "Const access failed because of another option";
+    }
+    bool caught = false;
+    try {
+      static_cast<void>(constParser.getOption<"jobs">());
+    } catch (const std::invalid_argument&) {
+      throw "Const access converted another option";
+    } catch (const std::logic_error&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Const access to a pending value not rejected";
+    }
+    static_cast<void>(mutableParser.getOption<"jobs">());
+    if (constParser.getOption<"jobs">().value != 8) {
+      throw "Converted value not readable through a const parser";
+    }
+  }
+  {
+    const char* argv[] = {"program", "--port", "80"};
+    auto mutableParser = parser;
+    mutableParser.parse(3, argv);
+    mutableParser.validateAll();
+    const auto& constParser = mutableParser;
+    if (constParser.getOption<"port">().value != 80 ||
+        constParser.getOption<"jobs">().value != 1) {
+      throw "Lazy values not converted by validateAll";
+    }
+  }
+}
+
+auto constraintTest() -> void {
+  constexpr auto parser =
+      ArgumentParser(optString<"input">("-i", "--input", "Input"),
+                     optBool<"json">("-j", "--json", "JSON"),
+                     optBool<"yaml">("-y", "--yaml", "YAML"),
+                     optString<"user">("-u", "--user", "User"),
+                     optString<"password">("-p", "--password", "Password"),
+                     optInt<"port">("-P", "--port", "Port", 80),
+                     optHelp("-h", "--help"))
+          .constrain(required<"input">(), exclusive<"json", "yaml">(),
+                     dependsOn<"user", "password">());
+  auto expectError = [&parser](std::initializer_list<const char*> args,
+                               std::string_view message) -> void {
+    std::vector<const char*> argv = {"program"};
+    argv.insert(argv.end(), args.begin(), args.end());
+    auto mutableParser = parser;
+    try {
+      mutableParser.parse(static_cast<int>(argv.size()), argv.data());
+    } catch (const std::invalid_argument& error) {
+      if (std::string_view(error.what()) == message) {
+        return;
+      }
+      throw "Constraint violation reported with a wrong message";
+    }
+    throw "Constraint violation not detected";
+  };
+  expectError({"-j"}, "Missing required option: --input");
+  expectError({"-i", "a", "-jy"},
+              "Options cannot be used together: --json, --yaml");
+  expectError({"-i", "a", "--user=me"}, "Option --user requires --password");
+  {
+    // --version answers even though the required options are missing
+    constexpr auto versioned =
+        ArgumentParser(optString<"input">("-i", "--input", "Input"),
+                       optCallback<"version">("-V", "--version", "Version",
+                                              testCallback))
+            .constrain(required<"input">());
+    globalCallbackCount = 0;
+    const char* argv[] = {"program", "--version"};
+    auto mutableParser = versioned;
+    mutableParser.parse(2, argv);
+    if (globalCallbackCount != 1) {
+      throw "Constraints checked before a terminal option";
+    }
+  }
+  {
+    const char* argv[] = {"program", "-i", "a", "-u", "me", "-p", "pw", "-y"};
+    auto mutableParser = parser;
+    mutableParser.parse(8, argv);
+    if (!mutableParser.given<"yaml">() || mutableParser.given<"json">() ||
+        mutableParser.given<"port">()) {
+      throw "Presence of options not recorded";
+    }
+  }
+  {
+    // A requires B requires C, but A excludes C; in a parser this is a
+    // compile error
+    detail::ConstraintMasks<3> masks;
+    masks.needs[0].set(1);
+    masks.needs[1].set(2);
+    masks.conflicts[0].set(2);
+    masks.conflicts[2].set(0);
+    bool caught = false;
+    try {
+      masks.close();
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught || !masks.needs[0].test(2)) {
+      throw "Contradictory constraints not rejected";
+    }
+  }
+}
+
+auto traceTest() -> void {
+  static_assert(sizeof(ArgumentParser(optInt<"port">("-p", "--port", "Port"))) ==
+                sizeof(makeParser<
+                       Traced<detail::DefaultParserStrategy, NoTrace>>(
+                    optInt<"port">("-p", "--port", "Port"))));
+  // Parsers spelled out with their option types keep compiling
+  static_assert(
+      std::is_same_v<decltype(ArgumentParser(
+                         optInt<"port">("-p", "--port", "Port"))),
+                     ArgumentParser<detail::DefaultParserStrategy,
+                                    detail::BasicSanitizer,
+                                    detail::Option<int, "port">>>);
+  constexpr auto parser =
+      makeParser<Traced<detail::DefaultParserStrategy, TraceRing<4>>>(
+          optInt<"port">("-p", "--port", "Port", 80),
+          optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+          optBool<"verbose">("-v", "--verbose", "Verbose"));
+  {
+    const char* argv[] = {"program", "--jobs=4", "-vp", "8080"};
+    auto mutableParser = parser;
+    mutableParser.parse(4, argv);
+    const auto& ring = mutableParser.trace();
+    if (ring.size() != 3 || ring.dropped() != 0) {
+      throw "Trace events not recorded per option";
+    }
+    if (ring[0].token != 1 || ring[0].option != 1 || ring[0].comparisons != 2 ||
+        ring[0].status != TraceStatus::OK) {
+      throw "Long option event has wrong fields";
+    }
+    if (ring[1].token != 2 || ring[1].option != 2 || ring[1].comparisons != 0 ||
+        ring[2].token != 2 || ring[2].option != 0) {
+      throw "Short cluster events have wrong fields";
+    }
+  }
+  {
+    const char* argv[] = {"program", "-p", "1", "-p", "2", "--jobs", "x"};
+    auto mutableParser = parser;
+    try {
+      mutableParser.parse(7, argv);
+    } catch (const std::invalid_argument&) {
+    }
+    const auto& ring = mutableParser.trace();
+    if (ring.size() != 3 || ring[2].status != TraceStatus::FAILED ||
+        ring[2].token != 5) {
+      throw "Failed conversion not traced";
+    }
+    const char* unknown[] = {"program", "--prot", "1"};
+    try {
+      mutableParser.parse(3, unknown);
+    } catch (const std::invalid_argument&) {
+    }
+    if (ring.size() != 4 || ring.dropped() != 0 ||
+        ring[3].status != TraceStatus::UNKNOWN_OPTION || ring[3].option != 3) {
+      throw "Unknown option not traced";
+    }
+    mutableParser.parse(3, argv);
+    if (ring.dropped() != 1 || ring[3].option != 0) {
+      throw "Ring buffer did not overwrite the oldest event";
+    }
+  }
+}
+
+auto attachedLongValueTest() -> void {
+  {
+    constexpr auto parser = ArgumentParser(
+        optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+        optString<"name">("-n", "--name", "Name"));
+    const char* argv[] = {"program", "--jobs=12", "--name=a=b"};
+    auto mutableParser = parser;
+    mutableParser.parse(3, argv);
+    if (mutableParser.getOption<"jobs">().value != 12) {
+      throw "--name=value not parsed";
+    }
+    if (mutableParser.getOption<"name">().value.value() != "a=b") {
+      throw "--name=value not split at first '='";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      constexpr auto parser =
+          ArgumentParser(optBool<"all">("-a", "--all", "All"));
+      const char* argv[] = {"program", "--all=yes"};
+      auto mutableParser = parser;
+      mutableParser.parse(2, argv);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Value for boolean long flag not rejected";
+    }
+  }
+}
+
+auto passThroughTest() -> void {
+  constexpr auto parser = makeParser<detail::PassThroughParserStrategy>(
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+      optBool<"verbose">("-v", "--verbose", "Verbose"));
+  const char* argv[] = {"wrapper", "--gpu=2", "-v",     "input.txt", "-x",
+                        "-j",      "4",       "--",     "-v",        "--jobs"};
+  auto mutableParser = parser;
+  mutableParser.parse(10, argv);
+  if (mutableParser.getOption<"jobs">().value != 4 ||
+      !mutableParser.getOption<"verbose">().value.value()) {
+    throw "Known options not parsed alongside pass-through";
+  }
+  const auto forwarded = mutableParser.passThroughArgs();
+  if (forwarded.size() != 5 || forwarded[0] != argv[1] ||
+      forwarded[1] != argv[3] || forwarded[2] != argv[4] ||
+      forwarded[3] != argv[8] || forwarded[4] != argv[9]) {
+    throw "Pass-through arguments not kept in order";
+  }
+  std::array<const char*, 8> buffer{};
+  const auto child = mutableParser.childArgv(buffer, {"/bin/tool", "--quiet"});
+  if (child.size() != 7 || child[0] != std::string_view("/bin/tool") ||
+      child[2] != argv[1] || buffer[7] != nullptr) {
+    throw "Child argv not built from the original pointers";
+  }
+  bool caught = false;
+  try {
+    std::array<const char*, 7> small{};
+    static_cast<void>(mutableParser.childArgv(small, {"a", "b"}));
+  } catch (const std::out_of_range&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Child argv overflow not detected";
+  }
+  caught = false;
+  try {
+    const char* mixed[] = {"wrapper", "-vx"};
+    mutableParser.parse(2, mixed);
+  } catch (const std::invalid_argument&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Cluster mixing known and unknown flags not rejected";
+  }
+}
+
+#if __has_include(<unistd.h>)
+// NUL-terminates each token, as find -print0 does
+auto nulJoined(std::initializer_list<std::string_view> tokens) -> std::string {
+  std::string joined;
+  for (const std::string_view token : tokens) {
+    joined += token;
+    joined += '\0';
+  }
+  return joined;
+}
+
+// Parses `input` written through a pipe by another thread
+template <std::size_t ChunkSize, typename Parser, typename OnBatch>
+auto parsePiped(Parser& parser, const std::string& input, OnBatch&& onBatch) {
+  int fds[2];
+  if (::pipe(fds) != 0) {
+    throw "pipe() failed";
+  }
+  std::thread writer([&input, fd = fds[1]]() -> void {
+    std::size_t written = 0;
+    while (written < input.size()) {
+      // Odd write sizes split tokens at every position over time
+      const std::size_t size =
+          std::min<std::size_t>(input.size() - written, 37);
+      const auto n = ::write(fd, input.data() + written, size);
+      if (n <= 0) {
+        break;
+      }
+      written += static_cast<std::size_t>(n);
+    }
+    ::close(fd);
+  });
+  struct Closer {
+    int fd;
+    std::thread& writer;
+    ~Closer() {
+      ::close(fd);
+      writer.join();
+    }
+  } closer{fds[0], writer};
+  return parser.template parseStream<ChunkSize>(fds[0], onBatch);
+}
+
+auto streamTest() -> void {
+  constexpr auto parser =
+      ArgumentParser(optString<"name">("-n", "--name", "Name"),
+                     optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+                     optList<"ids", int>("-i", "--ids", "IDs"),
+                     optBool<"verbose">("-v", "--verbose", "Verbose"),
+                     optFeatures<"features", "simd", "gpu">(
+                         "-f", "--features", "Features", "simd"),
+                     optMap<"set">("-D", "--set", "Settings"),
+                     optCount<"debug">("-d", "--debug", "Debug"));
+  constexpr std::size_t paths = 5000;
+  std::string input = nulJoined(
+      {"--name", "node-a", "-vj", "4", "--ids=1,2", "-f", "gpu", "-Da=1"});
+  for (std::size_t i = 0; i < paths; ++i) {
+    input += "/data/file-" + std::to_string(i) + '\0';
+    if (i == paths / 2) {
+      input += nulJoined({"-i", "3", "--features=-simd", "--set", "b=2",
+                          "-dd"});
+    }
+  }
+  // The last token may lack its terminator
+  input += nulJoined({"--"}) + "-v";
+  auto mutableParser = parser;
+  std::size_t positionals = 0;
+  std::size_t largest = 0;
+  std::vector<std::string> ids;
+  std::string last;
+  const auto text = parsePiped<64>(
+      mutableParser, input,
+      [&](std::span<const StreamArg> batch) -> void {
+        largest = std::max(largest, batch.size());
+        for (const StreamArg& arg : batch) {
+          if (arg.option == decltype(parser)::indexOf<"ids">()) {
+            ids.emplace_back(arg.text);
+          } else if (arg.option == StreamArg::positional) {
+            if (positionals < paths &&
+                arg.text != "/data/file-" + std::to_string(positionals)) {
+              throw "Streamed positionals out of order";
+            }
+            ++positionals;
+            last = arg.text;
+          }
+        }
+      });
+  if (std::string_view(mutableParser.getOption<"name">().value.value()) !=
+          "node-a" ||
+      mutableParser.getOption<"jobs">().value != 4 ||
+      !mutableParser.getOption<"verbose">().value.value()) {
+    throw "Streamed option values not kept";
+  }
+  if (positionals != paths + 1 || last != "-v") {
+    throw "Streamed positionals not delivered";
+  }
+  if (ids != std::vector<std::string>{"1,2", "3"}) {
+    throw "Repeatable option values not batched";
+  }
+  // Repeats accumulate as with parse(), viewing text the buffer no longer
+  // holds
+  const auto& features = mutableParser.getOption<"features">().value.value();
+  const auto& settings = mutableParser.getOption<"set">().value.value();
+  if (mutableParser.getOption<"ids">().value->size() != 3 ||
+      (*mutableParser.getOption<"ids">().value)[2] != 3 ||
+      features.has<"simd">() || !features.has<"gpu">() ||
+      settings.get<int>("a") != 1 || settings.get<int>("b") != 2 ||
+      mutableParser.getOption<"debug">().value != 2) {
+    throw "Streamed repeatable option values not applied";
+  }
+  if (largest == 0 || largest > 256) {
+    throw "Stream batches not bounded";
+  }
+  auto ignore = [](std::span<const StreamArg> /*unused*/) -> void {};
+  bool caught = false;
+  try {
+    static_cast<void>(parsePiped<16>(
+        mutableParser, nulJoined({"--name", "a-name-far-too-long"}), ignore));
+  } catch (const std::invalid_argument&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Argument longer than a chunk not rejected";
+  }
+  caught = false;
+  try {
+    static_cast<void>(
+        parsePiped<64>(mutableParser, nulJoined({"-v", "--jobs"}), ignore));
+  } catch (const std::invalid_argument& e) {
+    caught = std::string_view(e.what()) == "Option requires a value: --jobs";
+  }
+  if (!caught) {
+    throw "Missing value at the end of a stream not rejected";
+  }
+}
+#endif
+
+auto incrementalTest() -> void {
+  globalCallbackCount = 0;
+  auto parser = ArgumentParser(
+      optString<"name">("-n", "--name", "Name"),
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+      optList<"ids", int>("-i", "--ids", "IDs"),
+      optBool<"verbose">("-v", "--verbose", "Verbose"),
+      optCallback<"sync">("-s", "--sync", "Sync", testCallback),
+      optFeatures<"features", "simd", "gpu">("-f", "--features", "Features",
+                                             "simd"),
+      optMap<"set">("-D", "--set", "Settings"),
+      optCount<"debug">("-d", "--debug", "Debug"));
+  auto session = parser.incremental();
+  // Tokens arrive in a buffer the caller reuses
+  char line[32];
+  std::vector<std::pair<std::size_t, std::string>> events;
+  for (const char* token :
+       {"-vj", "4", "--name", "node-a", "--ids=1,2", "-f", "gpu", "-Da=1",
+        "-i3", "-d", "--features=-simd", "--set", "b=2", "-d", "-s", "run",
+        "--", "-v"}) {
+    std::snprintf(line, sizeof(line), "%s", token);
+    session.push(line);
+    if (std::string_view(token) == "-vj" &&
+        session.awaiting() != decltype(parser)::indexOf<"jobs">()) {
+      throw "Pending option value not tracked between tokens";
+    }
+    while (auto event = session.next()) {
+      events.emplace_back(event->option, event->text);
+    }
+  }
+  std::snprintf(line, sizeof(line), "%s", "overwritten");
+  if (globalCallbackCount != 0) {
+    throw "Callback run before the input ended";
+  }
+  session.finish();
+  const std::vector<std::pair<std::size_t, std::string>> expected = {
+      {3, ""},       {1, "4"},
+      {0, "node-a"}, {2, "1,2"},
+      {5, "gpu"},    {6, "a=1"},
+      {2, "3"},      {7, ""},
+      {5, "-simd"},  {6, "b=2"},
+      {7, ""},       {4, ""},
+      {ParseEvent::positional, "run"},
+      {ParseEvent::positional, "-v"}};
+  if (events != expected) {
+    throw "Incremental events not yielded as options completed";
+  }
+  const auto& features = parser.getOption<"features">().value.value();
+  const auto& settings = parser.getOption<"set">().value.value();
+  if (parser.getOption<"ids">().value->size() != 3 ||
+      (*parser.getOption<"ids">().value)[2] != 3 ||
+      features.has<"simd">() || !features.has<"gpu">() ||
+      settings.get<int>("a") != 1 || settings.get<int>("b") != 2 ||
+      parser.getOption<"debug">().value != 2) {
+    throw "Incremental repeatable option values not applied";
+  }
+  if (std::string_view(parser.getOption<"name">().value.value()) !=
+          "node-a" ||
+      parser.getOption<"jobs">().value != 4 || globalCallbackCount != 1 ||
+      !session.finished()) {
+    throw "Incremental parse not applied";
+  }
+  auto failing = parser.incremental();
+  failing.push("--jobs");
+  bool caught = false;
+  try {
+    failing.finish();
+  } catch (const std::invalid_argument&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Missing value at the end of input not rejected";
+  }
+  caught = false;
+  try {
+    failing.push("4");
+  } catch (const std::logic_error&) {
+    caught = true;
+  }
+  if (!caught) {
+    throw "Push after the end of input not rejected";
+  }
+}
+
+auto tableStrategyTest() -> void {
+  globalCallbackCount = 0;
+  constexpr auto parser =
+      makeParser<detail::TableParserStrategy>(
+          optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+          optInt<"port">("-p", "--port", "Port", 80),
+          optString<"name">("-n", "--name", "Name"),
+          optBool<"verbose">("-v", "--verbose", "Verbose"),
+          optCount<"debug">("-d", "--debug", "Debug"),
+          optList<"ids", int>("-i", "--ids", "IDs"),
+          optCallback<"sync">("-s", "--sync", "Sync", testCallback))
+          .constrain(required<"name">());
+  // Options of one value type share a converter
+  constexpr auto table =
+      detail::OptionTable<3>::build(optInt<"jobs">("-j", "--jobs", "Jobs"),
+                                    optInt<"port">("-p", "--port", "Port"),
+                                    optBool<"verbose">("-v", "--verbose"));
+  static_assert(table.entries[0].store == table.entries[1].store);
+  if (table.entries[0].store == table.entries[2].store) {
+    throw "Converter shared across value types";
+  }
+  const char* argv[] = {"program", "-vdj4", "--name=node", "--ids",
+                        "1,2",     "-i3",   "-sd",         "--port",
+                        "8080"};
+  auto mutableParser = parser;
+  mutableParser.parse(9, argv);
+  if (mutableParser.getOption<"jobs">().value != 4 ||
+      mutableParser.getOption<"port">().value != 8080 ||
+      std::string_view(mutableParser.getOption<"name">().value.value()) !=
+          "node" ||
+      !mutableParser.getOption<"verbose">().value.value() ||
+      mutableParser.getOption<"debug">().value != 2 ||
+      mutableParser.getOption<"ids">().value->size() != 3 ||
+      globalCallbackCount != 1 || !mutableParser.given<"sync">()) {
+    throw "Table-driven strategy did not apply options";
+  }
+  auto errorFor = [&parser](std::initializer_list<const char*> args)
+      -> std::string {
+    std::vector<const char*> argvList = {"program"};
+    argvList.insert(argvList.end(), args.begin(), args.end());
+    try {
+      auto failing = parser;
+      failing.parse(static_cast<int>(argvList.size()), argvList.data());
+    } catch (const std::invalid_argument& e) {
+      return e.what();
+    }
+    return "";
+  };
+  if (errorFor({"--name", "a", "-j"}) != "Option requires a value: -j" ||
+      errorFor({"--nmae", "a"}) != "Unknown option: --nmae" ||
+      errorFor({"-n", "a", "-vx"}) != "Unknown option: -x in -vx" ||
+      errorFor({"-n", "a", "--verbose=1"}) !=
+          "Option does not take a value: --verbose=1" ||
+      errorFor({"-n", "a", "file"}) !=
+          "Unexpected positional argument: file" ||
+      errorFor({"-v"}) != "Missing required option: --name") {
+    throw "Table-driven strategy errors differ from the default strategy";
+  }
+}
+
+auto optionIndexTest() -> void {
+  constexpr auto index = detail::OptionIndex<2>::build(
+      optInt<"port">("-p", "--port", "Port"),
+      optBool<"verbose">(std::nullopt, "--verbose", "Verbose"));
+  static_assert(index.findShort('p') == 0);
+  static_assert(index.findShort('v') == detail::OptionIndex<2>::npos);
+  static_assert(index.findLong("verbose") == 1);
+  static_assert(index.findLong("verb") == detail::OptionIndex<2>::npos);
+  static_assert(index.findLong("") == detail::OptionIndex<2>::npos);
+  if (index.findShort('\xff') != detail::OptionIndex<2>::npos) {
+    throw "Non-ASCII short flag lookup failed";
+  }
+  std::size_t comparisons = 0;
+  if (index.findLong("porx", comparisons) != detail::OptionIndex<2>::npos ||
+      comparisons != 1) {
+    throw "Long name comparisons not counted by the lookup";
+  }
+}
+
+auto completionTest() -> void {
+  constexpr auto parser = ArgumentParser(
+      optInt<"port">("-p", "--port", "Port", 80),
+      optBool<"verbose">("-v", "--verbose", "Verbose output"),
+      optBool<"version">(std::nullopt, "--version", "Print version"),
+      opt<OneOfStr<"fast", "safe", "slow">, "mode">("-m", "--mode", "Mode"));
+  auto reply = [&parser](std::initializer_list<const char*> args) -> std::string {
+    std::vector<const char*> argv = {"program"};
+    argv.insert(argv.end(), args.begin(), args.end());
+    return parser
+        .completionReply(static_cast<int>(argv.size()), argv.data())
+        .value_or("<none>");
+  };
+  if (reply({"--__complete", "1", "program", "--ver"}) !=
+      "--verbose\tVerbose output\n--version\tPrint version\n") {
+    throw "Long flags not completed by prefix";
+  }
+  if (reply({"--__complete", "1", "program", "--x"}).size() != 0) {
+    throw "Unknown prefix produced candidates";
+  }
+  const std::string all = reply({"--__complete", "1", "program"});
+  if (all.find("--mode\tMode\n") == std::string::npos ||
+      all.find("\n-v\tVerbose output\n") == std::string::npos) {
+    throw "Empty word did not list every flag";
+  }
+  if (reply({"--__complete", "2", "program", "--mode", "s"}) !=
+      "safe\nslow\n") {
+    throw "Values of a fixed set not completed";
+  }
+  if (reply({"--__complete", "1", "program", "--mode=f"}) !=
+      "--mode=fast\n" ||
+      reply({"--__complete", "3", "program", "--mode", "=", ""}) !=
+          "fast\nsafe\nslow\n") {
+    throw "Values after '=' not completed";
+  }
+  if (reply({"--__complete", "2", "program", "-p", ""}).size() != 0) {
+    throw "Free-form value completed with flags";
+  }
+  if (reply({"-v"}) != "<none>") {
+    throw "Ordinary command line treated as a completion request";
+  }
+  const std::string bash = reply({"--__completion-script", "bash"});
+  if (bash.find("complete -o default -F _etched_program program") ==
+          std::string::npos ||
+      completionScript(Shell::ZSH, "/usr/bin/my-tool")
+              .find("compdef _etched_my_tool my-tool") == std::string::npos) {
+    throw "Completion script not generated";
+  }
+}
+
+auto editDistanceTest() -> void {
+  static_assert(detail::EditDistance("port").distance("port") == 0);
+  static_assert(detail::EditDistance("prot").distance("port") == 2);
+  static_assert(detail::EditDistance("verbos").distance("verbose") == 1);
+  static_assert(detail::EditDistance("kitten").distance("sitting") == 3);
+  static_assert(detail::EditDistance("").distance("abc") == 3);
+  static_assert(detail::EditDistance("abc").distance("") == 3);
+
+  // Cross-check against the quadratic dynamic programming definition
+  const char* words[] = {"help",   "hlep",    "output", "outptu", "a",
+                         "worker", "workers", "dry-run", "dryrun", "xyz"};
+  for (const char* a : words) {
+    for (const char* b : words) {
+      std::string_view s1(a);
+      std::string_view s2(b);
+      std::array<std::size_t, 16> row{};
+      for (std::size_t j = 0; j <= s2.size(); ++j) {
+        row[j] = j;
+      }
+      for (std::size_t i = 1; i <= s1.size(); ++i) {
+        std::size_t diag = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= s2.size(); ++j) {
+          std::size_t up = row[j];
+          row[j] = std::min({row[j] + 1, row[j - 1] + 1,
+                             diag + (s1[i - 1] == s2[j - 1] ? 0 : 1)});
+          diag = up;
+        }
+      }
+      if (detail::EditDistance(s1).distance(s2) != row[s2.size()]) {
+        throw "Bit-parallel edit distance mismatch";
+      }
+    }
+  }
+}
+
+auto suggestionTest() -> void {
+  constexpr auto index = detail::OptionIndex<3>::build(
+      optInt<"port">("-p", "--port", "Port"),
+      optInt<"sort">("-s", "--sort", "Sort"),
+      optBool<"verbose">("-v", "--verbose", "Verbose"));
+  constexpr auto found = detail::suggest(index, "ort");
+  static_assert(found.count == 2 && found.idx[0] == 0 && found.idx[1] == 1);
+  static_assert(detail::suggest(index, "verbos").idx[0] == 2);
+  static_assert(detail::suggest(index, "completely-off").count == 0);
+
+  std::string message;
+  try {
+    constexpr auto parser = ArgumentParser(
+        optInt<"port">("-p", "--port", "Port"),
+        optBool<"verbose">("-v", "--verbose", "Verbose"));
+    const char* argv[] = {"program", "--verbsoe"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+  } catch (const std::invalid_argument& e) {
+    message = e.what();
+  }
+  if (message.find("did you mean --verbose?") == std::string::npos) {
+    throw "Suggestion missing for mistyped long option";
+  }
+  message.clear();
+  try {
+    constexpr auto parser =
+        ArgumentParser(optBool<"verbose">("-v", "--verbose", "Verbose"));
+    const char* argv[] = {"program", "-verbose"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+  } catch (const std::invalid_argument& e) {
+    message = e.what();
+  }
+  if (message.find("did you mean --verbose?") == std::string::npos) {
+    throw "Suggestion missing for single-dash long option";
+  }
+}
+
 struct TestPoint {
   double x;
   double y;
@@ -946,8 +2026,27 @@ auto parserTests() -> void {
   positionalArgTest();
   maxArgumentsTest();
   callbackTest();
+  deferredCallbackTest();
   stringWithSpacesTest();
   terminalOptionTest();
+  bundledShortFlagsTest();
+  countFlagTest();
+  liveReloadTest();
+  globalParserTest();
+  lazyConversionTest();
+  constraintTest();
+  traceTest();
+  attachedLongValueTest();
+  passThroughTest();
+#if __has_include(<unistd.h>)
+  streamTest();
+#endif
+  incrementalTest();
+  tableStrategyTest();
+  optionIndexTest();
+  completionTest();
+  editDistanceTest();
+  suggestionTest();
   customTypePointTest();
   customTypeColorTest();
   customTypeParserTest();
@@ -4,10 +4,12 @@
 #define ETCHED_LIB_ETCHED_TEST_HPP
 
 #include "etched-parser-tests.hpp"
+#include "etched-value-tests.hpp"
 
 namespace etched::tests {
 auto mainTests() -> void {
   parserTests();
+  valueTests();
 }
 }  // namespace etched::tests
 
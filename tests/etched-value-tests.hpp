@@ -0,0 +1,831 @@
+#pragma once
+#ifndef ETCHED_LIB_ETCHED_VALUE_TESTS_HPP
+#define ETCHED_LIB_ETCHED_VALUE_TESTS_HPP
+
+#include <algorithm>
+#include <cstdio>
+#include <etched/etched.hpp>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace etched::tests {
+
+// Captures what printHelpOption writes for a single option
+template <typename Opt>
+auto helpLine(const Opt& option) -> std::string {
+  std::ostringstream captured;
+  auto* previous = std::cout.rdbuf(captured.rdbuf());
+  detail::DefaultParserStrategy::printHelpOption(option);
+  std::cout.rdbuf(previous);
+  return captured.str();
+}
+
+auto parseIntegerTest() -> void {
+  static_assert(detail::parseInteger<int>("42", 0, 100) == 42);
+  static_assert(detail::parseInteger<int>("-7", -10, 10) == -7);
+  static_assert(detail::parseInteger<int>("+7", -10, 10) == 7);
+  static_assert(detail::parseInteger<int64_t>("-9223372036854775808",
+                                              INT64_MIN, INT64_MAX) ==
+                INT64_MIN);
+  static_assert(detail::parseInteger<uint64_t>("18446744073709551615", 0,
+                                               UINT64_MAX) == UINT64_MAX);
+  static_assert(detail::parseInteger<unsigned>("-0", 0, 10) == 0);
+  {
+    bool caught = false;
+    try {
+      // Rejected at the third digit, long before the end of the input
+      detail::parseInteger<int>("1000000000000000000000000", 0, 100);
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Accumulated value above max not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      detail::parseInteger<int>("5", 10, 20);
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Value below min not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      detail::parseInteger<int>("12a", 0, 1000);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Trailing garbage not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      detail::parseInteger<int>("-", -10, 10);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Lone sign not rejected";
+    }
+  }
+}
+
+auto boundedTest() -> void {
+  using Port = Bounded<uint16_t, 1, 65535>;
+  using Ratio = Bounded<double, 0.0, 1.0>;
+  if (fromStr<Port>("8080").get() != 8080) {
+    throw "Bounded integer conversion failed";
+  }
+  if (fromStr<Ratio>("0.25").get() != 0.25) {
+    throw "Bounded float conversion failed";
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<Port>("0");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Bounded lower limit not enforced";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<Ratio>("1.5");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Bounded float upper limit not enforced";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        opt<Port, "port">("-p", "--port", "Port", Port{8080}),
+        opt<Bounded<int8_t, -5, 5>, "level">("-l", "--level", "Level", 0));
+    const char* argv[] = {"program", "--level=-3"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+    if (mutableParser.getOption<"level">().value.value() != -3) {
+      throw "Bounded option not parsed";
+    }
+    if (mutableParser.getOption<"port">().value.value() != 8080) {
+      throw "Bounded default value lost";
+    }
+  }
+  if (helpLine(opt<Bounded<int8_t, -5, 5>, "level">("-l", "--level",
+                                                     "Level")) !=
+      "-l, --level <value> [-5..5]    Level\n") {
+    throw "Bounded limits missing from help";
+  }
+}
+
+auto oneOfTest() -> void {
+  using Workers = OneOf<1, 2, 4, 8>;
+  using Mode = OneOfStr<"fast", "safe">;
+  static_assert(Workers::lowest() == 1 && Workers::highest() == 8);
+  if (fromStr<Workers>("4").get() != 4) {
+    throw "OneOf integer conversion failed";
+  }
+  if (fromStr<Mode>("safe").get() != "safe") {
+    throw "OneOfStr string conversion failed";
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<Workers>("3");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "OneOf integer outside set not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<Mode>("fastest");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "OneOfStr string outside set not rejected";
+    }
+  }
+  if (helpLine(opt<Mode, "mode">("-m", "--mode", "Mode")) !=
+      "-m, --mode <value> {fast|safe}    Mode\n") {
+    throw "OneOf values missing from help";
+  }
+}
+
+auto tokenizerTest() -> void {
+  static_assert([] {
+    Tokenizer<','> fields("a,,bc");
+    return fields.next() == "a" && fields.next().empty() &&
+           fields.next() == "bc" && fields.done();
+  }());
+  std::size_t count = 0;
+  std::size_t length = 0;
+  for (std::string_view field : Tokenizer<':'>("usr:local:bin")) {
+    ++count;
+    length += field.size();
+  }
+  if (count != 3 || length != 11) {
+    throw "Tokenizer range iteration failed";
+  }
+}
+
+auto fromViewTest() -> void {
+  if (fromView<int>(std::string_view("123456", 3)) != 123) {
+    throw "fromView<int> read past the view";
+  }
+  if (fromView<double>("+2.5") != 2.5) {
+    throw "fromView<double> failed";
+  }
+  if (fromView<TestPoint>("1.5,2").y != 2.0) {
+    throw "fromView fallback to fromStr failed";
+  }
+  {
+    bool caught = false;
+    try {
+      fromView<double>("2.5x");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "fromView<double> trailing garbage not rejected";
+    }
+  }
+}
+
+auto compositeTest() -> void {
+  {
+    auto value = fromStr<std::tuple<int, double, std::string_view>>("1,2.5,x");
+    if (std::get<0>(value) != 1 || std::get<1>(value) != 2.5 ||
+        std::get<2>(value) != "x") {
+      throw "Tuple conversion failed";
+    }
+  }
+  {
+    auto value = fromStr<std::pair<uint8_t, char>>("255,z");
+    if (value.first != 255 || value.second != 'z') {
+      throw "Pair conversion failed";
+    }
+  }
+  {
+    auto value = fromStr<Delimited<std::array<int, 2>, 'x'>>("1920x1080");
+    if (value.get()[0] != 1920 || value.get()[1] != 1080) {
+      throw "Delimited array conversion failed";
+    }
+  }
+  {
+    auto value =
+        fromStr<std::array<Bounded<int, 0, 255>, 3>>("10,20,30");
+    if (value[2].get() != 30) {
+      throw "Array of bounded values failed";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<std::array<int, 3>>("1,2");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Too few fields not detected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<std::pair<int, int>>("1,2,3");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Too many fields not detected";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        opt<std::pair<double, double>, "position">("-p", "--position",
+                                                   "Position"));
+    const char* argv[] = {"program", "--position=-1.5,3"};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+    auto position = mutableParser.getOption<"position">().value.value();
+    if (position.first != -1.5 || position.second != 3.0) {
+      throw "Composite option not parsed";
+    }
+  }
+}
+
+auto byteSizeTest() -> void {
+  static_assert(detail::parseByteSize("4096") == 4096);
+  static_assert(detail::parseByteSize("64K") == 64 * 1024);
+  static_assert(detail::parseByteSize("64KiB") == 64 * 1024);
+  static_assert(detail::parseByteSize("10MB") == 10'000'000);
+  static_assert(detail::parseByteSize("1.5GiB") == 1'610'612'736);
+  static_assert(detail::parseByteSize("2B") == 2);
+  {
+    bool caught = false;
+    try {
+      detail::parseByteSize("16EiB");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Byte size overflow not detected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      detail::parseByteSize("12Q");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Unknown size suffix not detected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<ByteSize<4096, 1024 * 1024>>("2M");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "ByteSize limit not enforced";
+    }
+  }
+  if (helpLine(opt<ByteSize<4096, 1024 * 1024>, "buffer">("-b", "--buffer",
+                                                          "Buffer")) !=
+      "-b, --buffer <value> [4KiB..1MiB]    Buffer\n") {
+    throw "ByteSize limits missing from help";
+  }
+}
+
+auto durationTest() -> void {
+  using std::chrono::milliseconds;
+  using std::chrono::seconds;
+  if (fromStr<milliseconds>("250ms") != milliseconds(250)) {
+    throw "Millisecond duration failed";
+  }
+  if (fromStr<seconds>("2h30m") != seconds(9000)) {
+    throw "Compound duration failed";
+  }
+  if (fromStr<milliseconds>("1.5s") != milliseconds(1500)) {
+    throw "Fractional duration failed";
+  }
+  if (fromStr<seconds>("30") != seconds(30)) {
+    throw "Bare number duration failed";
+  }
+  // Exact decimal fractions must not lose a tick to rounding
+  {
+    using std::chrono::nanoseconds;
+    using Millis = Duration<milliseconds>;
+    using Nanos = Duration<nanoseconds>;
+    if (fromStr<Millis>("0.05s").get() != milliseconds(50) ||
+        fromStr<Millis>("0.13s").get() != milliseconds(130) ||
+        fromStr<Millis>("1.13s").get() != milliseconds(1130) ||
+        fromStr<Millis>("2.05s").get() != milliseconds(2050)) {
+      throw "Fractional milliseconds duration not exact";
+    }
+    if (fromStr<Nanos>("0.05s").get() != nanoseconds(50'000'000) ||
+        fromStr<Nanos>("0.13s").get() != nanoseconds(130'000'000) ||
+        fromStr<Nanos>("0.05h").get() != nanoseconds(180'000'000'000) ||
+        fromStr<Nanos>("1.999999999s").get() != nanoseconds(1'999'999'999)) {
+      throw "Fractional nanoseconds duration not exact";
+    }
+    if (fromStr<ByteSize<>>("0.5K").get() != 512 ||
+        fromStr<ByteSize<>>("1.1MB").get() != 1'100'000) {
+      throw "Fractional byte size not exact";
+    }
+    for (const char* partial : {"1.5", "0.5B", "0.3K"}) {
+      bool caught = false;
+      try {
+        static_cast<void>(fromStr<ByteSize<>>(partial));
+      } catch (const std::invalid_argument&) {
+        caught = true;
+      }
+      if (!caught) {
+        throw "Byte size that is not whole bytes accepted";
+      }
+    }
+  }
+  if (fromStr<std::chrono::duration<double>>("1m30s").count() != 90.0) {
+    throw "Floating point duration failed";
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<seconds>("250ms");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Lossy duration conversion not detected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<seconds>("5y");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Unknown duration unit not detected";
+    }
+  }
+  using Timeout = Duration<milliseconds, 100, 30000>;
+  {
+    bool caught = false;
+    try {
+      fromStr<Timeout>("1m");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Duration limit not enforced";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        opt<Timeout, "timeout">("-t", "--timeout", "Timeout",
+                                Timeout{milliseconds(500)}),
+        opt<ByteSize<>, "buffer">("-b", "--buffer", "Buffer"));
+    const char* argv[] = {"program", "-t", "2s", "--buffer=64K"};
+    auto mutableParser = parser;
+    mutableParser.parse(4, argv);
+    if (mutableParser.getOption<"timeout">().value->get() !=
+        milliseconds(2000)) {
+      throw "Duration option not parsed";
+    }
+    if (mutableParser.getOption<"buffer">().value->get() != 65536) {
+      throw "ByteSize option not parsed";
+    }
+  }
+  if (helpLine(opt<Timeout, "timeout">("-t", "--timeout", "Timeout")) !=
+      "-t, --timeout <value> [100ms..30000ms]    Timeout\n") {
+    throw "Duration limits missing from help";
+  }
+}
+
+enum class Codec : uint8_t { NONE, LZ4, ZSTD, GZIP };
+
+auto enumTest() -> void {
+  using CodecValue =
+      EnumValue<Codec, {"none", Codec::NONE}, {"lz4", Codec::LZ4},
+                {"zstd", Codec::ZSTD}, {"gzip", Codec::GZIP},
+                {"gz", Codec::GZIP}>;
+  static_assert(CodecValue::fromName("zstd").get() == Codec::ZSTD);
+  static_assert(CodecValue::fromName("gz").get() == Codec::GZIP);
+  static_assert(CodecValue::fromName("gzip").name() == "gzip");
+  static_assert(CodecValue::table.maxProbe == 1);
+  {
+    bool caught = false;
+    try {
+      fromStr<CodecValue>("lz5");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Unknown enum name not rejected";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        optEnum<"codec", Codec, {"none", Codec::NONE}, {"lz4", Codec::LZ4},
+                {"zstd", Codec::ZSTD}>("-c", "--codec", "Codec", Codec::NONE));
+    const char* argv[] = {"program", "--codec", "lz4"};
+    auto mutableParser = parser;
+    if (mutableParser.getOption<"codec">().value.value() != Codec::NONE) {
+      throw "Enum default value lost";
+    }
+    mutableParser.parse(3, argv);
+    if (mutableParser.getOption<"codec">().value.value() != Codec::LZ4) {
+      throw "Enum option not parsed";
+    }
+  }
+  if (helpLine(optEnum<"codec", Codec, {"none", Codec::NONE},
+                       {"lz4", Codec::LZ4}>("-c", "--codec", "Codec")) !=
+      "-c, --codec <value> {none|lz4}    Codec\n") {
+    throw "Enum names missing from help";
+  }
+}
+
+auto featureSetTest() -> void {
+  using Features = FeatureSet<"simd", "gpu", "trace", "jit">;
+  static_assert(Features("simd,jit").mask() == 0b1001);
+  static_assert(Features("simd,gpu,-simd,+trace").has<"trace">());
+  static_assert(!Features("simd,gpu,-simd").has<"simd">());
+  {
+    bool caught = false;
+    try {
+      fromStr<Features>("simd,avx");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Unknown feature name not rejected";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        optFeatures<"features", "simd", "gpu", "trace", "jit">(
+            "-f", "--features", "Feature gates", "simd,trace"));
+    const char* argv[] = {"program", "--features=-trace,gpu", "-f", "jit"};
+    auto mutableParser = parser;
+    mutableParser.parse(4, argv);
+    auto features = mutableParser.getOption<"features">().value.value();
+    if (features.mask() != 0b1011) {
+      throw "Feature edits not applied to the default set";
+    }
+    if (features.bits() != std::bitset<4>("1011")) {
+      throw "Feature bitset conversion failed";
+    }
+  }
+  {
+    // More than one word of features
+    using Wide = FeatureSet<"f00", "f01", "f02", "f03", "f04", "f05", "f06",
+                            "f07", "f08", "f09", "f10", "f11", "f12", "f13",
+                            "f14", "f15", "f16", "f17", "f18", "f19", "f20",
+                            "f21", "f22", "f23", "f24", "f25", "f26", "f27",
+                            "f28", "f29", "f30", "f31", "f32", "f33", "f34",
+                            "f35", "f36", "f37", "f38", "f39", "f40", "f41",
+                            "f42", "f43", "f44", "f45", "f46", "f47", "f48",
+                            "f49", "f50", "f51", "f52", "f53", "f54", "f55",
+                            "f56", "f57", "f58", "f59", "f60", "f61", "f62",
+                            "f63", "f64", "f65">;
+    auto wide = fromStr<Wide>("f01,f65");
+    if (!wide.has<"f65">() || !wide.has<"f01">() || wide.bits().count() != 2) {
+      throw "Multi-word feature set failed";
+    }
+  }
+}
+
+auto keyValueMapTest() -> void {
+  // Held twice per option, in its value and its default
+  static_assert(sizeof(KeyValueMap<>) <= 1024);
+  static_assert([] {
+    KeyValueMap<4> map;
+    map.insert("a=1");
+    map.insert("b=");
+    map.insert("a=3");
+    return map.size() == 2 && map.find("a") == "3" && map.find("b") == "" &&
+           !map.contains("c") && map.begin()->first == "a";
+  }());
+  {
+    constexpr auto parser =
+        ArgumentParser(optMap<"set">("-D", "--set", "Override a setting"),
+                       optInt<"jobs">("-j", "--jobs", "Jobs", 1));
+    const char* argv[] = {"program",  "--set",  "threads=8", "-Dname=edge",
+                          "--set=ratio=0.5", "-j", "2", "--set", "threads=16"};
+    auto mutableParser = parser;
+    mutableParser.parse(9, argv);
+    const auto& settings = mutableParser.getOption<"set">().value.value();
+    if (settings.size() != 3 || settings.get<int>("threads") != 16 ||
+        settings.get<double>("ratio") != 0.5 ||
+        settings.find("name") != "edge") {
+      throw "Key=value settings not collected";
+    }
+    if (settings.get<int>("missing") || settings.getOr<int>("missing", 7) != 7) {
+      throw "Missing key not reported";
+    }
+    if (settings.find("name")->data() != argv[3] + 7) {
+      throw "Key=value setting copied instead of viewed";
+    }
+  }
+  {
+    // Values inserted directly need not be NUL-terminated
+    constexpr std::string_view text = "4096";
+    KeyValueMap<2> map;
+    map.insert("size", text.substr(0, 2));
+    if (map.get<int>("size") != 40) {
+      throw "Key=value value read past its length";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      KeyValueMap<2> map;
+      map.insert("novalue");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Setting without '=' not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      KeyValueMap<2> map;
+      map.insert("a=1");
+      map.insert("b=1");
+      map.insert("c=1");
+    } catch (const std::out_of_range&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Key=value capacity not enforced";
+    }
+  }
+}
+
+auto listTest() -> void {
+  {
+    const std::string_view text = "a,bb,,ccc,dddddddd,eeeeeeeee,f,";
+    if (detail::countByte(text, ',') != 7 || detail::countByte("", ',') != 0) {
+      throw "Delimiter count failed";
+    }
+  }
+  {
+    constexpr auto parser = ArgumentParser(
+        optList<"ids", int64_t>("-i", "--ids", "IDs"),
+        optList<"weights", double, ':'>("-w", "--weights", "Weights"));
+    const char* argv[] = {"program", "--ids=1,-2,3", "-w", "0.5:+1.5",
+                          "-i", "40"};
+    auto mutableParser = parser;
+    mutableParser.parse(6, argv);
+    const auto& ids = mutableParser.getOption<"ids">().value.value();
+    const auto& weights = mutableParser.getOption<"weights">().value.value();
+    if (ids.get() != std::vector<int64_t>{1, -2, 3, 40} ||
+        weights.span().size() != 2 || weights[1] != 1.5) {
+      throw "List values not parsed";
+    }
+  }
+  {
+    std::string text;
+    std::vector<int64_t> expected;
+    for (int64_t i = 0; i < 1000; ++i) {
+      text += std::to_string(i * 7919 - 3000) + ",";
+      expected.push_back(i * 7919 - 3000);
+    }
+    text.pop_back();
+    for (std::size_t chunks = 1; chunks <= 5; ++chunks) {
+      std::vector<int64_t> out = {99};
+      detail::parseListParallel<int64_t, ','>(text, chunks, out);
+      if (out.size() != expected.size() + 1 ||
+          !std::equal(expected.begin(), expected.end(), out.begin() + 1)) {
+        throw "Parallel list conversion failed";
+      }
+    }
+    bool caught = false;
+    try {
+      std::vector<int64_t> out;
+      detail::parseListParallel<int64_t, ','>(text + ",x", 3, out);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Parallel list error not propagated";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<List<int>>("1,,2");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Empty list field not rejected";
+    }
+  }
+}
+
+auto fileContentsTest() -> void {
+  const std::string path = "etched-file-contents-test.bin";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "schema v1";
+  }
+  {
+    constexpr auto parser =
+        ArgumentParser(optFile<"schema">("-s", "--schema", "Schema file"));
+    const std::string arg = "--schema=@" + path;
+    const char* argv[] = {"program", arg.c_str()};
+    auto mutableParser = parser;
+    mutableParser.parse(2, argv);
+    const auto& schema = mutableParser.getOption<"schema">().value.value();
+    if (schema.mapped()) {
+      throw "File mapped before first access";
+    }
+    if (schema.view() != "schema v1" || schema.bytes().size() != 9 ||
+        !schema.mapped()) {
+      throw "File contents not mapped";
+    }
+    const FileContents copy = schema;
+    if (copy.mapped() || copy.view() != schema.view()) {
+      throw "File contents copy failed";
+    }
+  }
+  {
+    // Mapped before the values are shared between threads
+    constexpr auto parser =
+        ArgumentParser(optFile<"schema">("-s", "--schema", "Schema file"));
+    const std::string arg = "--schema=" + path;
+    const char* argv[] = {"program", arg.c_str()};
+    GlobalParser global{parser};
+    global.parse(2, argv);
+    if (!global.getOption<"schema">().value->mapped()) {
+      throw "File contents not mapped before publishing";
+    }
+    LiveOptions<decltype(parser), 1> live(parser);
+    live.reload(arg);
+    const auto reader = live.registerReader();
+    const auto view = reader.read();
+    if (!view.getOption<"schema">().value->mapped()) {
+      throw "Reloaded file contents not mapped before publishing";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      fromStr<FileContents>("@etched-no-such-file");
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Missing file not rejected";
+    }
+  }
+  std::remove(path.c_str());
+}
+
+auto snapshotTest() -> void {
+  constexpr auto parser = ArgumentParser(
+      optInt<"jobs">("-j", "--jobs", "Jobs", 1),
+      optString<"name">("-n", "--name", "Name"),
+      optBool<"dry">("-d", "--dry-run", "Dry run"),
+      optCount<"verbose", 3>("-v", "--verbose", "Verbosity"),
+      optEnum<"codec", Codec, {"none", Codec::NONE}, {"zstd", Codec::ZSTD}>(
+          "-c", "--codec", "Codec", Codec::NONE),
+      optList<"ids", int64_t>("-i", "--ids", "IDs"),
+      optMap<"set">("-D", "--set", "Settings"),
+      opt<OneOfStr<"fast", "safe">, "mode">("-m", "--mode", "Mode"),
+      opt<Duration<std::chrono::milliseconds>, "timeout">("-t", "--timeout",
+                                                          "Timeout"),
+      opt<std::pair<int, std::string_view>, "pair">("-p", "--pair", "Pair"));
+  std::vector<std::byte> blob;
+  {
+    // Arguments go out of scope before the snapshot is restored
+    std::string name = "worker";
+    std::string setting = "--set=zone=eu-1";
+    const char* argv[] = {"program", "-vv",        "--name",
+                          name.c_str(), "--codec=zstd", "--ids=4,5,6",
+                          setting.c_str(), "-m",        "safe",
+                          "-t",         "1.5s",         "-p",
+                          "7,seven"};
+    auto mutableParser = parser;
+    mutableParser.parse(13, argv);
+    blob = mutableParser.snapshot();
+  }
+  auto restored = parser;
+  restored.getOption<"jobs">().value = std::nullopt;
+  restored.restore(blob);
+  if (restored.getOption<"jobs">().value != 1 ||
+      restored.getOption<"name">().value != "worker" ||
+      restored.getOption<"dry">().value.has_value() ||
+      restored.getOption<"verbose">().value.value() != 2 ||
+      restored.getOption<"codec">().value.value() != Codec::ZSTD ||
+      restored.getOption<"ids">().value->get() !=
+          std::vector<int64_t>{4, 5, 6} ||
+      restored.getOption<"set">().value->get<std::string_view>("zone") !=
+          "eu-1" ||
+      restored.getOption<"mode">().value->get() != "safe" ||
+      restored.getOption<"timeout">().value->get().count() != 1500 ||
+      restored.getOption<"pair">().value->second != "seven") {
+    throw "Snapshot not restored";
+  }
+  if (!restored.given<"name">() || restored.given<"jobs">()) {
+    throw "Snapshot presence not restored";
+  }
+  {
+    // A flag and an enumerator are the last two bytes of this blob
+    auto small = ArgumentParser(
+        optBool<"dry">("-d", "--dry-run", "Dry run"),
+        optEnum<"codec", Codec, {"none", Codec::NONE},
+                {"zstd", Codec::ZSTD}>("-c", "--codec", "Codec"));
+    const char* argv[] = {"program", "-d", "--codec=zstd"};
+    small.parse(3, argv);
+    const auto valid = small.snapshot();
+    auto corrupt = [&small, &valid](std::size_t offset, uint8_t byte) {
+      auto bytes = valid;
+      bytes[bytes.size() - offset] = std::byte{byte};
+      try {
+        small.restore(bytes);
+      } catch (const std::invalid_argument&) {
+        return true;
+      }
+      return false;
+    };
+    if (!corrupt(2, 2)) {
+      throw "Corrupt bool in snapshot not rejected";
+    }
+    if (!corrupt(1, static_cast<uint8_t>(Codec::LZ4))) {
+      throw "Enumerator outside the allowed set not rejected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      auto other = ArgumentParser(optInt<"jobs">("-j", "--jobs", "Jobs", 1));
+      other.restore(blob);
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Snapshot schema mismatch not detected";
+    }
+  }
+  {
+    bool caught = false;
+    try {
+      restored.restore(std::span(blob).first(blob.size() - 1));
+    } catch (const std::invalid_argument&) {
+      caught = true;
+    }
+    if (!caught) {
+      throw "Truncated snapshot not detected";
+    }
+  }
+}
+
+auto valueTests() -> void {
+  parseIntegerTest();
+  boundedTest();
+  oneOfTest();
+  tokenizerTest();
+  fromViewTest();
+  compositeTest();
+  byteSizeTest();
+  durationTest();
+  enumTest();
+  featureSetTest();
+  keyValueMapTest();
+  listTest();
+  fileContentsTest();
+  snapshotTest();
+}
+
+}  // namespace etched::tests
+
+#endif